@@ -53,7 +53,21 @@ int getConfigData(char *fileName, ConfigDataType **configData)
 
     tempData = (ConfigDataType *) malloc(sizeof(ConfigDataType));
 
-    while(lineCtr < NUM_DATA_LINES)
+    // set defaults for optional lines
+    tempData->timerModeCode = TIMER_REAL_CODE;
+    tempData->logFormatCode = LOG_FORMAT_TEXT_CODE;
+    tempData->ioWorkerThreads = 1;
+    tempData->ioQueueDepth = 64;
+    tempData->memModeCode = MEM_MODE_SEGMENTED_CODE;
+    tempData->pageSizeKB = 4;
+    tempData->tlbEntries = 64;
+    tempData->tlbWays = 4;
+    tempData->pagePolicyCode = PAGE_POLICY_FIFO_CODE;
+    tempData->pageFaultTime = 10;
+
+    // read data lines until the end descriptor, optional lines may appear
+    // anywhere but all required lines must be found
+    while(isConfigEnd(fileAccessPtr) == False)
     {
         // get line leader (e.g., file path)
         if(getLineTo(fileAccessPtr, MAX_STR_LEN, COLON,
@@ -61,6 +75,12 @@ int getConfigData(char *fileName, ConfigDataType **configData)
         {
             free(tempData);
             fclose(fileAccessPtr);
+
+            // all data found, so the end descriptor must be broken
+            if(lineCtr >= NUM_DATA_LINES)
+            {
+                return CFG_CORRUPT_DESCRIPTOR_ERR;
+            }
             return INCOMPLETE_FILE_ERR;
         }
         // get data line by number in enum
@@ -78,7 +98,11 @@ int getConfigData(char *fileName, ConfigDataType **configData)
             else if( (dataLineCode == CFG_MD_FILE_NAME_CODE)
                             || (dataLineCode == CFG_LOG_FILE_NAME_CODE)
                             || (dataLineCode == CFG_CPU_SCHED_CODE)
-                            || (dataLineCode == CFG_LOG_TO_CODE) )
+                            || (dataLineCode == CFG_LOG_TO_CODE)
+                            || (dataLineCode == CFG_TIMER_MODE_CODE)
+                            || (dataLineCode == CFG_LOG_FORMAT_CODE)
+                            || (dataLineCode == CFG_MEM_MODE_CODE)
+                            || (dataLineCode == CFG_PAGE_POLICY_CODE) )
             {
                 fscanf(fileAccessPtr, "%s", dataBuffer);
             }
@@ -128,6 +152,47 @@ int getConfigData(char *fileName, ConfigDataType **configData)
                     case CFG_LOG_FILE_NAME_CODE:
                         copyString(tempData->logToFileName, dataBuffer);
                         break;
+
+                    case CFG_TIMER_MODE_CODE:
+                        tempData->timerModeCode = getTimerModeCode(dataBuffer);
+                        break;
+
+                    case CFG_LOG_FORMAT_CODE:
+                        tempData->logFormatCode = getLogFormatCode(dataBuffer);
+                        break;
+
+                    case CFG_IO_WORKERS_CODE:
+                        tempData->ioWorkerThreads = intData;
+                        break;
+
+                    case CFG_IO_QUEUE_DEPTH_CODE:
+                        tempData->ioQueueDepth = intData;
+                        break;
+
+                    case CFG_MEM_MODE_CODE:
+                        tempData->memModeCode = getMemModeCode(dataBuffer);
+                        break;
+
+                    case CFG_PAGE_SIZE_CODE:
+                        tempData->pageSizeKB = intData;
+                        break;
+
+                    case CFG_TLB_ENTRIES_CODE:
+                        tempData->tlbEntries = intData;
+                        break;
+
+                    case CFG_TLB_WAYS_CODE:
+                        tempData->tlbWays = intData;
+                        break;
+
+                    case CFG_PAGE_POLICY_CODE:
+                        tempData->pagePolicyCode
+                                        = getPagePolicyCode(dataBuffer);
+                        break;
+
+                    case CFG_PAGE_FAULT_TIME_CODE:
+                        tempData->pageFaultTime = intData;
+                        break;
                 }
             }
             // data value not in range
@@ -146,7 +211,28 @@ int getConfigData(char *fileName, ConfigDataType **configData)
             return CFG_CORRUPT_PROMPT_ERR;
         }
 
-        lineCtr++;
+        // only required lines count toward a complete file
+        if(dataLineCode <= CFG_LOG_FILE_NAME_CODE)
+        {
+            lineCtr++;
+        }
+    }
+
+    // check all required lines were found
+    if(lineCtr < NUM_DATA_LINES)
+    {
+        free(tempData);
+        fclose(fileAccessPtr);
+        return INCOMPLETE_FILE_ERR;
+    }
+
+    // TLB sets must each hold the given number of ways
+    if(tempData->tlbWays > tempData->tlbEntries
+                            || tempData->tlbEntries % tempData->tlbWays != 0)
+    {
+        free(tempData);
+        fclose(fileAccessPtr);
+        return CFG_DATA_OUT_OF_RANGE_ERR;
     }
 
     // Check for end of sim config string
@@ -253,6 +339,86 @@ int getDataLineCode( char *dataBuffer )
         return CFG_LOG_FILE_NAME_CODE;
     }
 
+    // check for timer mode string (optional)
+        // func: compareString
+    if( compareString( dataBuffer, "Timer Mode" ) == STR_EQ )
+    {
+        // return timer mode code
+        return CFG_TIMER_MODE_CODE;
+    }
+
+    // check for log format string (optional)
+        // func: compareString
+    if( compareString( dataBuffer, "Log Format" ) == STR_EQ )
+    {
+        // return log format code
+        return CFG_LOG_FORMAT_CODE;
+    }
+
+    // check for I/O worker threads string (optional)
+        // func: compareString
+    if( compareString( dataBuffer, "I/O Worker Threads" ) == STR_EQ )
+    {
+        // return I/O worker threads code
+        return CFG_IO_WORKERS_CODE;
+    }
+
+    // check for I/O queue depth string (optional)
+        // func: compareString
+    if( compareString( dataBuffer, "I/O Queue Depth" ) == STR_EQ )
+    {
+        // return I/O queue depth code
+        return CFG_IO_QUEUE_DEPTH_CODE;
+    }
+
+    // check for memory mode string (optional)
+        // func: compareString
+    if( compareString( dataBuffer, "Memory Mode" ) == STR_EQ )
+    {
+        // return memory mode code
+        return CFG_MEM_MODE_CODE;
+    }
+
+    // check for page size string (optional)
+        // func: compareString
+    if( compareString( dataBuffer, "Page Size (KB)" ) == STR_EQ )
+    {
+        // return page size code
+        return CFG_PAGE_SIZE_CODE;
+    }
+
+    // check for TLB entries string (optional)
+        // func: compareString
+    if( compareString( dataBuffer, "TLB Entries" ) == STR_EQ )
+    {
+        // return TLB entries code
+        return CFG_TLB_ENTRIES_CODE;
+    }
+
+    // check for TLB ways string (optional)
+        // func: compareString
+    if( compareString( dataBuffer, "TLB Ways" ) == STR_EQ )
+    {
+        // return TLB ways code
+        return CFG_TLB_WAYS_CODE;
+    }
+
+    // check for page replacement string (optional)
+        // func: compareString
+    if( compareString( dataBuffer, "Page Replacement" ) == STR_EQ )
+    {
+        // return page replacement code
+        return CFG_PAGE_POLICY_CODE;
+    }
+
+    // check for page fault time string (optional)
+        // func: compareString
+    if( compareString( dataBuffer, "Page Fault Time (msec)" ) == STR_EQ )
+    {
+        // return page fault time code
+        return CFG_PAGE_FAULT_TIME_CODE;
+    }
+
     // at this point, assume failed string access, return corrupt prompt error
     return CFG_CORRUPT_PROMPT_ERR;
 }
@@ -394,6 +560,42 @@ Boolean valueInRange(int lineCode, int intVal, double doubleVal, char *stringVal
             }
             break;
 
+        case CFG_IO_WORKERS_CODE:
+            if(intVal < 1 || intVal > 64)
+            {
+                result = False;
+            }
+            break;
+
+        case CFG_IO_QUEUE_DEPTH_CODE:
+            if(intVal < 1 || intVal > 4096)
+            {
+                result = False;
+            }
+            break;
+
+        case CFG_PAGE_SIZE_CODE:
+            if(intVal < 1 || intVal > 1024)
+            {
+                result = False;
+            }
+            break;
+
+        case CFG_TLB_ENTRIES_CODE:
+        case CFG_TLB_WAYS_CODE:
+            if(intVal < 1 || intVal > 4096)
+            {
+                result = False;
+            }
+            break;
+
+        case CFG_PAGE_FAULT_TIME_CODE:
+            if(intVal < 0 || intVal > 10000)
+            {
+                result = False;
+            }
+            break;
+
         case CFG_LOG_TO_CODE:
             strLen = getStringLength(stringVal);
             tempStr = (char *)malloc(strLen + 1);
@@ -407,6 +609,61 @@ Boolean valueInRange(int lineCode, int intVal, double doubleVal, char *stringVal
             }
             free(tempStr);
             break;
+
+        case CFG_TIMER_MODE_CODE:
+            strLen = getStringLength(stringVal);
+            tempStr = (char *)malloc(strLen + 1);
+            setStrToLowerCase(tempStr, stringVal);
+
+            if( (compareString(tempStr, "real") != STR_EQ)
+                    && (compareString(tempStr, "virtual") != STR_EQ)
+                    && (compareString(tempStr, "paced") != STR_EQ) )
+            {
+                result = False;
+            }
+            free(tempStr);
+            break;
+
+        case CFG_LOG_FORMAT_CODE:
+            strLen = getStringLength(stringVal);
+            tempStr = (char *)malloc(strLen + 1);
+            setStrToLowerCase(tempStr, stringVal);
+
+            if( (compareString(tempStr, "text") != STR_EQ)
+                    && (compareString(tempStr, "binary") != STR_EQ) )
+            {
+                result = False;
+            }
+            free(tempStr);
+            break;
+
+        case CFG_MEM_MODE_CODE:
+            strLen = getStringLength(stringVal);
+            tempStr = (char *)malloc(strLen + 1);
+            setStrToLowerCase(tempStr, stringVal);
+
+            if( (compareString(tempStr, "segmented") != STR_EQ)
+                    && (compareString(tempStr, "paged") != STR_EQ) )
+            {
+                result = False;
+            }
+            free(tempStr);
+            break;
+
+        case CFG_PAGE_POLICY_CODE:
+            strLen = getStringLength(stringVal);
+            tempStr = (char *)malloc(strLen + 1);
+            setStrToLowerCase(tempStr, stringVal);
+
+            if( (compareString(tempStr, "fifo") != STR_EQ)
+                    && (compareString(tempStr, "lru") != STR_EQ)
+                    && (compareString(tempStr, "clock") != STR_EQ)
+                    && (compareString(tempStr, "aging") != STR_EQ) )
+            {
+                result = False;
+            }
+            free(tempStr);
+            break;
     }
     return result;
 }
@@ -461,6 +718,229 @@ ConfigDataCodes getLogToCode( char *logToStr )
     return returnVal;
 }
 
+/*
+Function name:  getTimerModeCode
+Algorithm:      converts string data (e.g., "Virtual", "paced") to constant
+                code number to be stored as integer
+Precondition:   timerModeStr is a C-Style string with one of the specified
+                timer modes
+Postcondition:  returns code representing timer mode
+Exceptions:     defaults to real (busy wait) timer code
+Notes: none
+ */
+ConfigDataCodes getTimerModeCode( char *timerModeStr )
+{
+    // intialize func/variables
+
+        // create temp str
+            // func: getStringLength, malloc
+        int strLen = getStringLength( timerModeStr );
+        char *tempStr = (char *)malloc( strLen + 1 );
+
+        // set default return value to real time
+        int returnVal = TIMER_REAL_CODE;
+
+    // set temp string to lower case
+        // fucntion: setStrToLowerCase
+    setStrToLowerCase( tempStr, timerModeStr );
+
+    // check for VIRTUAL
+        // func: compareString
+    if( compareString( tempStr, "virtual" ) == STR_EQ )
+    {
+        // set return value to virtual code
+        returnVal = TIMER_VIRTUAL_CODE;
+    }
+
+    // check for PACED
+        // func: compareString
+    if( compareString( tempStr, "paced" ) == STR_EQ )
+    {
+        // set return value to paced code
+        returnVal = TIMER_PACED_CODE;
+    }
+
+    // free temp string memory
+        //func: free
+    free( tempStr );
+
+    // return code found
+    return returnVal;
+}
+
+/*
+Function name:  getLogFormatCode
+Algorithm:      converts string data (e.g., "Binary", "text") to constant
+                code number to be stored as integer
+Precondition:   logFormatStr is a C-Style string with one of the specified
+                log formats
+Postcondition:  returns code representing log file format
+Exceptions:     defaults to text code
+Notes: none
+ */
+ConfigDataCodes getLogFormatCode( char *logFormatStr )
+{
+    // intialize func/variables
+
+        // create temp str
+            // func: getStringLength, malloc
+        int strLen = getStringLength( logFormatStr );
+        char *tempStr = (char *)malloc( strLen + 1 );
+
+        // set default return value to text
+        int returnVal = LOG_FORMAT_TEXT_CODE;
+
+    // set temp string to lower case
+        // fucntion: setStrToLowerCase
+    setStrToLowerCase( tempStr, logFormatStr );
+
+    // check for BINARY
+        // func: compareString
+    if( compareString( tempStr, "binary" ) == STR_EQ )
+    {
+        // set return value to binary code
+        returnVal = LOG_FORMAT_BINARY_CODE;
+    }
+
+    // free temp string memory
+        //func: free
+    free( tempStr );
+
+    // return code found
+    return returnVal;
+}
+
+/*
+Function name:  getMemModeCode
+Algorithm:      converts string data (e.g., "Paged", "segmented") to constant
+                code number to be stored as integer
+Precondition:   memModeStr is a C-Style string with one of the specified
+                memory modes
+Postcondition:  returns code representing memory mode
+Exceptions:     defaults to segmented code
+Notes: none
+ */
+ConfigDataCodes getMemModeCode( char *memModeStr )
+{
+    // intialize func/variables
+
+        // create temp str
+            // func: getStringLength, malloc
+        int strLen = getStringLength( memModeStr );
+        char *tempStr = (char *)malloc( strLen + 1 );
+
+        // set default return value to segmented
+        int returnVal = MEM_MODE_SEGMENTED_CODE;
+
+    // set temp string to lower case
+        // fucntion: setStrToLowerCase
+    setStrToLowerCase( tempStr, memModeStr );
+
+    // check for PAGED
+        // func: compareString
+    if( compareString( tempStr, "paged" ) == STR_EQ )
+    {
+        // set return value to paged code
+        returnVal = MEM_MODE_PAGED_CODE;
+    }
+
+    // free temp string memory
+        //func: free
+    free( tempStr );
+
+    // return code found
+    return returnVal;
+}
+
+/*
+Function name:  getPagePolicyCode
+Algorithm:      converts string data (e.g., "LRU", "clock") to constant
+                code number to be stored as integer
+Precondition:   pagePolicyStr is a C-Style string with one of the specified
+                page replacement policies
+Postcondition:  returns code representing page replacement policy
+Exceptions:     defaults to FIFO code
+Notes: none
+ */
+ConfigDataCodes getPagePolicyCode( char *pagePolicyStr )
+{
+    // intialize func/variables
+
+        // create temp str
+            // func: getStringLength, malloc
+        int strLen = getStringLength( pagePolicyStr );
+        char *tempStr = (char *)malloc( strLen + 1 );
+
+        // set default return value to FIFO
+        int returnVal = PAGE_POLICY_FIFO_CODE;
+
+    // set temp string to lower case
+        // fucntion: setStrToLowerCase
+    setStrToLowerCase( tempStr, pagePolicyStr );
+
+    // check for LRU
+        // func: compareString
+    if( compareString( tempStr, "lru" ) == STR_EQ )
+    {
+        // set return value to LRU code
+        returnVal = PAGE_POLICY_LRU_CODE;
+    }
+
+    // check for CLOCK
+        // func: compareString
+    if( compareString( tempStr, "clock" ) == STR_EQ )
+    {
+        // set return value to CLOCK code
+        returnVal = PAGE_POLICY_CLOCK_CODE;
+    }
+
+    // check for AGING
+        // func: compareString
+    if( compareString( tempStr, "aging" ) == STR_EQ )
+    {
+        // set return value to aging code
+        returnVal = PAGE_POLICY_AGING_CODE;
+    }
+
+    // free temp string memory
+        //func: free
+    free( tempStr );
+
+    // return code found
+    return returnVal;
+}
+
+/*
+Function name:  isConfigEnd
+Algorithm:      looks ahead for the end descriptor without consuming it,
+                file position is restored before returning
+Precondition:   file is open and positioned at the start of a data line
+                or the end descriptor
+Postcondition:  returns True if the next text is the end descriptor,
+                False otherwise
+Exceptions:     none
+Notes: none
+ */
+Boolean isConfigEnd( FILE *filePtr )
+{
+    char dataBuffer[ MAX_STR_LEN ];
+    long filePosition = ftell( filePtr );
+    Boolean result = False;
+
+    if( (getLineTo(filePtr, MAX_STR_LEN, PERIOD, dataBuffer,
+                        IGNORE_LEADING_WS) == NO_ERR)
+                             && (compareString(dataBuffer,
+                                "End Simulator Configuration File") == STR_EQ) )
+    {
+        result = True;
+    }
+
+    // return to line start, also clears any end of file flag
+    fseek( filePtr, filePosition, SEEK_SET );
+
+    return result;
+}
+
 /*
 Function name:  displayConfigData
 Algorithm:      diagnostic function to show config data output
@@ -489,6 +969,20 @@ void displayConfigData( ConfigDataType *configData )
     configCodeToString( configData->logToCode, displayString );
     printf("Log to selection        : %s\n", displayString );
     printf("Log file name           : %s\n", configData->logToFileName );
+    configCodeToString( configData->timerModeCode, displayString );
+    printf("Timer mode              : %s\n", displayString );
+    configCodeToString( configData->logFormatCode, displayString );
+    printf("Log format              : %s\n", displayString );
+    printf("I/O worker threads      : %d\n", configData->ioWorkerThreads );
+    printf("I/O queue depth         : %d\n", configData->ioQueueDepth );
+    configCodeToString( configData->memModeCode, displayString );
+    printf("Memory mode             : %s\n", displayString );
+    printf("Page size (KB)          : %d\n", configData->pageSizeKB );
+    printf("TLB entries             : %d\n", configData->tlbEntries );
+    printf("TLB ways                : %d\n", configData->tlbWays );
+    configCodeToString( configData->pagePolicyCode, displayString );
+    printf("Page replacement        : %s\n", displayString );
+    printf("Page fault time (msec)  : %d\n", configData->pageFaultTime );
 }
 
 /*
@@ -504,10 +998,13 @@ Notes: none
  */
 void configCodeToString( int code, char *outString )
 {
-    // Define array with eight items, and short (10) lengths
-    char displayStrings[ 8 ][ 10 ] = {  "SJF-N", "SRTF-P", "FCFS-P",
+    // Define array with nineteen items, and short (10) lengths
+    char displayStrings[ 19 ][ 10 ] = { "SJF-N", "SRTF-P", "FCFS-P",
                                         "RR-P", "FCFS-N", "Monitor",
-                                        "File", "Both" };
+                                        "File", "Both", "Real",
+                                        "Virtual", "Paced", "Text",
+                                        "Binary", "Segmented", "Paged",
+                                        "FIFO", "LRU", "CLOCK", "Aging" };
     // copy string to return paramter
         //func: copyString
     copyString( outString, displayStrings[ code ] );
@@ -18,7 +18,17 @@ typedef enum {  CFG_FILE_ACCESS_ERR = 3,
                 CFG_PROC_CYCLES_CODE,
                 CFG_IO_CYCLES_CODE,
                 CFG_LOG_TO_CODE,
-                CFG_LOG_FILE_NAME_CODE } ConfigCodeMessages;
+                CFG_LOG_FILE_NAME_CODE,
+                CFG_TIMER_MODE_CODE,
+                CFG_LOG_FORMAT_CODE,
+                CFG_IO_WORKERS_CODE,
+                CFG_IO_QUEUE_DEPTH_CODE,
+                CFG_MEM_MODE_CODE,
+                CFG_PAGE_SIZE_CODE,
+                CFG_TLB_ENTRIES_CODE,
+                CFG_TLB_WAYS_CODE,
+                CFG_PAGE_POLICY_CODE,
+                CFG_PAGE_FAULT_TIME_CODE } ConfigCodeMessages;
 
 
 typedef enum {  CPU_SCHED_SJF_N_CODE,
@@ -28,7 +38,18 @@ typedef enum {  CPU_SCHED_SJF_N_CODE,
                 CPU_SCHED_FCFS_N_CODE,
                 LOGTO_MONITOR_CODE,
                 LOGTO_FILE_CODE,
-                LOGTO_BOTH_CODE } ConfigDataCodes;
+                LOGTO_BOTH_CODE,
+                TIMER_REAL_CODE,
+                TIMER_VIRTUAL_CODE,
+                TIMER_PACED_CODE,
+                LOG_FORMAT_TEXT_CODE,
+                LOG_FORMAT_BINARY_CODE,
+                MEM_MODE_SEGMENTED_CODE,
+                MEM_MODE_PAGED_CODE,
+                PAGE_POLICY_FIFO_CODE,
+                PAGE_POLICY_LRU_CODE,
+                PAGE_POLICY_CLOCK_CODE,
+                PAGE_POLICY_AGING_CODE } ConfigDataCodes;
 
 // config data structure
 typedef struct
@@ -42,6 +63,16 @@ typedef struct
     int ioCycleRate;
     int logToCode;
     char logToFileName[ 100 ];
+    int timerModeCode;
+    int logFormatCode;
+    int ioWorkerThreads;    // service threads per I/O device
+    int ioQueueDepth;       // most ops waiting per I/O device
+    int memModeCode;
+    int pageSizeKB;
+    int tlbEntries;
+    int tlbWays;            // entries per TLB set
+    int pagePolicyCode;
+    int pageFaultTime;      // msec of I/O charged per page fault
 } ConfigDataType;
 
 // function prototypes
@@ -50,6 +81,11 @@ int getDataLineCode( char *dataBuffer );
 ConfigDataCodes getCpuSchedCode( char *codeStr );
 Boolean valueInRange( int lineCode, int intVal, double doubleVal, char *stringVal );
 ConfigDataCodes getLogToCode( char *logToStr );
+ConfigDataCodes getTimerModeCode( char *timerModeStr );
+ConfigDataCodes getLogFormatCode( char *logFormatStr );
+ConfigDataCodes getMemModeCode( char *memModeStr );
+ConfigDataCodes getPagePolicyCode( char *pagePolicyStr );
+Boolean isConfigEnd( FILE *filePtr );
 void displayConfigData( ConfigDataType *configData );
 void configCodeToString( int code, char *outString );
 void displayConfigError( int errCode );
@@ -0,0 +1,92 @@
+// header files
+#include <stdio.h>
+#include "SimLogFormat.h"
+
+/*
+Function Name:  main
+Algorithm:      reads a binary simulator log file and prints it in the
+                same text format the simulator writes to text log files
+Precondition:   first command line argument names a binary log file
+                written with Log Format: Binary
+Postcondition:  decoded log is displayed to the monitor
+Exceptions:     reports unreadable, foreign or truncated log files
+Notes:          redirect output to produce a text log file
+ */
+int main( int argc, char **argv )
+{
+    FILE *logFile;
+    BinaryLogHeader fileHeader;
+    LogEvent logEvent;
+    char outString[ MAX_STR_LEN ];
+    long long lastUSec = 0;
+    int textLength, readResult;
+
+    if( argc < 2 )
+    {
+        printf( "ERROR: Program requires file name for binary log file" );
+        printf( " as command line argument\n" );
+        return 1;
+    }
+
+    logFile = fopen( argv[ 1 ], "rb" );
+
+    if( logFile == NULL )
+    {
+        printf( "ERROR: Unable to open log file %s\n", argv[ 1 ] );
+        return 1;
+    }
+
+    // check file is a binary log this program can read
+    if( fread( &fileHeader, sizeof( BinaryLogHeader ), 1, logFile ) != 1
+        || compareString( fileHeader.magic, (char *) BINARY_LOG_MAGIC ) != STR_EQ
+        || fileHeader.version != BINARY_LOG_VERSION )
+    {
+        printf( "ERROR: %s is not a version %d binary log file\n",
+                                               argv[ 1 ], BINARY_LOG_VERSION );
+        fclose( logFile );
+        return 1;
+    }
+
+    // loop across all records
+    readResult = readLogRecord( logFile, &lastUSec, &logEvent );
+
+    while( readResult == LOG_RECORD_READ )
+    {
+        // text records are followed by their text
+        if( logEvent.eventCode == LOG_TEXT_EVENT )
+        {
+            textLength = logEvent.operand;
+
+            if( textLength < 0 || textLength >= MAX_STR_LEN
+                || fread( outString, 1, textLength, logFile )
+                                                      != (size_t) textLength )
+            {
+                printf( "ERROR: Truncated log file %s\n", argv[ 1 ] );
+                fclose( logFile );
+                return 1;
+            }
+
+            outString[ textLength ] = NULL_CHAR;
+        }
+
+        // otherwise format event as the simulator would
+        else
+        {
+            formatLogEvent( &logEvent, outString );
+        }
+
+        printf( "%s", outString );
+
+        readResult = readLogRecord( logFile, &lastUSec, &logEvent );
+    }
+
+    fclose( logFile );
+
+    if( readResult == LOG_RECORD_TRUNCATED )
+    {
+        printf( "ERROR: Truncated log file %s\n", argv[ 1 ] );
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+// header files
+#include <stdio.h>
+#include "MetaDataAccess.h"
+
+/*
+Function Name:  main
+Algorithm:      loads and validates a meta data file, then writes it as a
+                compiled image that the simulator maps without parsing
+Precondition:   first command line argument names a meta data file,
+                second names the image file to write
+Postcondition:  image file holds the op table, process ranges and process
+                cycle totals, with a checksum
+Exceptions:     reports meta data errors as the simulator does, and image
+                files that can not be written
+Notes:          an image can be used as File Path in any config file
+ */
+int main( int argc, char **argv )
+{
+    OpTable *opTable;
+    int accessResult;
+
+    if( argc < 3 )
+    {
+        printf( "ERROR: Program requires meta data file name and image" );
+        printf( " file name as command line arguments\n" );
+        return 1;
+    }
+
+    accessResult = getOpCodes( argv[ 1 ], &opTable );
+
+    if( accessResult != NO_ERR )
+    {
+        displayMetaDataError( accessResult );
+        printf( "\n" );
+        return 1;
+    }
+
+    if( writeOpTableImage( argv[ 2 ], opTable ) != NO_ERR )
+    {
+        printf( "ERROR: Unable to write image file %s\n", argv[ 2 ] );
+        opTable = clearOpTable( opTable );
+        return 1;
+    }
+
+    printf( "Compiled %d ops in %d processes to %s\n", opTable->numOps,
+                                            opTable->numProcesses, argv[ 2 ] );
+
+    opTable = clearOpTable( opTable );
+
+    return 0;
+}
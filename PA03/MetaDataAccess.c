@@ -1,117 +1,124 @@
 // header files
+#include <fcntl.h>      // for open
+#include <string.h>     // for memchr, memcmp
+#include <sys/mman.h>   // for mmap
+#include <sys/stat.h>   // for fstat
+#include <unistd.h>     // for close
 #include "MetaDataAccess.h"
 
+// constants identifying compiled meta data image files
+const char MD_IMAGE_MAGIC[] = "SIMMDB1";
+const int MD_IMAGE_VERSION = 2;
+
 /*
 Function Name:  getOpCodes
 Algorithm:      opens file, acquires op code data, returns pointer
-                to head of linked list
+                to op table
 Precondition:   for correct operation, file is avilable, is formatted correctly,
                 and has all correctly formed op codes
-Postcondition:  in correct operation, returns pointer to head of
-                op code linked list
+Postcondition:  in correct operation, returns pointer to op table holding
+                all op commands in file order and each process's op range
 Exceptions:     correctly and appropriately (without program failure)
                 responds to and reports file access failure,
                 incorrectly formatted lead or end descriptors,
                 incorrectly formatted prompt, incorrect op code letter,
                 incorrect op code name, op code value out of range,
                 and incomplete file conditions
-Notes: none
+Notes: op table is sized once from the number of op commands in the file;
+       a compiled image file (see writeOpTableImage) is loaded as is
  */
-int getOpCodes( char *fileName, OpCodeType **opCodeDataHead )
+int getOpCodes( char *fileName, OpTable **opTablePtr )
 {
     // initialize function/variables
 
-        // intialize read only constant
-        const char READ_ONLY_FLAG[] = "r";
-
         // initialize start and end counts for balanced app operations
         int startCount = 0, endCount = 0;
 
-        // intialize local head pointer to null
-        OpCodeType *localHeadPtr = NULL;
+        // initialize first process without an A(end) to none
+        int firstOpenProc = 0;
 
         // intialize variables
         int accessResult;
         char dataBuffer[ MAX_STR_LEN ];
-        OpCodeType *newNodePtr;
-        FILE *fileAccessPtr;
+        OpCodeType newOp;
+        OpTable *localTablePtr;
+        MetaDataFile mdFile;
 
-    // intialize op code data pointer in case of return error
-    *opCodeDataHead = NULL;
+    // intialize op table pointer in case of return error
+    *opTablePtr = NULL;
 
-    // open file for reading
-        // function: fopen
-    fileAccessPtr = fopen( fileName, READ_ONLY_FLAG );
-
-    // check for file open failure
-    if( fileAccessPtr == NULL )
+    // map file into memory for reading
+        // function: openMetaDataFile
+    if( openMetaDataFile( fileName, &mdFile ) != NO_ERR )
     {
         // return file access error
         return MD_FILE_ACCESS_ERR;
     }
 
+    // check for compiled image, load it without parsing
+        // func: isMetaDataImage, loadOpTableImage
+    if( isMetaDataImage( &mdFile ) == True )
+    {
+        accessResult = loadOpTableImage( &mdFile, opTablePtr );
+
+        // unmap file, if not kept by op table
+            // func: closeMetaDataFile
+        closeMetaDataFile( &mdFile );
+
+        return accessResult;
+    }
+
     // check first line for correct leader
-        // function: getLineTo, compareString
-    if( getLineTo( fileAccessPtr, MAX_STR_LEN, COLON,
+        // function: getMappedLineTo, compareString
+    if( getMappedLineTo( &mdFile, MAX_STR_LEN, COLON,
                         dataBuffer, IGNORE_LEADING_WS ) != NO_ERR
     || compareString( dataBuffer, "Start Program Meta-Data Code" ) != STR_EQ )
     {
-        // close file
-            // func: fclose
-        fclose( fileAccessPtr );
+        // unmap file
+            // func: closeMetaDataFile
+        closeMetaDataFile( &mdFile );
 
         // return corrupt descriptor error
         return MD_CORRUPT_DESCRIPTOR_ERR;
     }
 
-    // allocate memory for the temporary data structure
-        // function: malloc
-    newNodePtr = ( OpCodeType * ) malloc( sizeof( OpCodeType ) );
+    // create op table with room for every op command in the file
+        // func: createOpTable, countOpCommands
+    localTablePtr = createOpTable( countOpCommands( &mdFile ) );
 
     // get the first op command
         // functoin: getOpCommand
-    accessResult = getOpCommand( fileAccessPtr, newNodePtr );
+    accessResult = getOpCommand( &mdFile, &newOp );
 
     // get start and end counts for later comparison
         // func: updateStartCount, updateEndCount
-    startCount = updateStartCount( startCount, newNodePtr->opName );
-    endCount = updateEndCount( endCount, newNodePtr->opName );
+    startCount = updateStartCount( startCount, newOp.opName );
+    endCount = updateEndCount( endCount, newOp.opName );
 
-    // check for failure of first complete op command
-    if( accessResult != COMPLETE_OPCMD_FOUND_MSG )
-    {
-        // close file
-            // func: fclose
-        fclose( fileAccessPtr );
-
-        // clear data from the structure list
-            // func: clearMetaDataList
-        *opCodeDataHead = clearMetaDataList( localHeadPtr );
-
-        // free temp structure memory
-            // func: free
-        free( newNodePtr );
-
-        // return result of operation
-        return accessResult;
-    }
     // loop across all remaining op commands
     //  (while complete op commands are found)
-
     while( accessResult == COMPLETE_OPCMD_FOUND_MSG )
     {
-        // add the new op command to the linked list
-            // func: addNode
-        localHeadPtr = addNode( localHeadPtr, newNodePtr );
+        // add the new op command to the end of the op table
+            // func: addOpToTable
+        addOpToTable( localTablePtr, &newOp );
+
+        // check for app end, ends any process still open
+            // func: closeOpenProcesses
+        if( newOp.opKind == APP_END_OP )
+        {
+            closeOpenProcesses( localTablePtr, &firstOpenProc,
+                                                localTablePtr->numOps - 1 );
+        }
 
         // get a new op command
             // func: getOpCommand
-        accessResult = getOpCommand( fileAccessPtr, newNodePtr );
+        accessResult = getOpCommand( &mdFile, &newOp );
 
         // update start and end counts for later comparison
             // func: updateStartCount, updateEndCount
-        startCount = updateStartCount( startCount, newNodePtr->opName );
-        endCount = updateEndCount( endCount, newNodePtr->opName );
+        startCount = updateStartCount( startCount, newOp.opName );
+        endCount = updateEndCount( endCount, newOp.opName );
     }
 
     // after loop completion, check for last op command found
@@ -120,16 +127,22 @@ int getOpCodes( char *fileName, OpCodeType **opCodeDataHead )
         // check for start and end op code counts equal
         if( startCount == endCount )
         {
-            // add the last node to the linked list
-                // func: addNode
-            localHeadPtr = addNode( localHeadPtr, newNodePtr );
-
-            // set access result to no error for later operation
+            // add the last op command to the op table,
+            // any process still open ends here
+                // func: addOpToTable, closeOpenProcesses
+            addOpToTable( localTablePtr, &newOp );
+            closeOpenProcesses( localTablePtr, &firstOpenProc,
+                                                localTablePtr->numOps - 1 );
+
+            // set access result to no error for later operation,
+            // add up each process's cycles
+                // func: setProcessTotals
             accessResult = NO_ERR;
+            setProcessTotals( localTablePtr );
 
             // check last line for incorrect end descriptor
-                // func: getLineTo, compareString
-            if( getLineTo( fileAccessPtr, MAX_STR_LEN, PERIOD,
+                // func: getMappedLineTo, compareString
+            if( getMappedLineTo( &mdFile, MAX_STR_LEN, PERIOD,
                             dataBuffer, IGNORE_LEADING_WS ) != NO_ERR
                 || compareString( dataBuffer, "End Program Meta-Data Code" )
                                                                     != STR_EQ )
@@ -150,21 +163,17 @@ int getOpCodes( char *fileName, OpCodeType **opCodeDataHead )
     // check for any errors found (not no error)
     if (accessResult != NO_ERR )
     {
-        // clear the op command list
-            // func: clearMetaDataList
-        localHeadPtr = clearMetaDataList( localHeadPtr );
+        // clear the op table
+            // func: clearOpTable
+        localTablePtr = clearOpTable( localTablePtr );
     }
 
-    // close access file
-        // func: fclose
-    fclose( fileAccessPtr );
-
-    // release temporary structure memory
-        // fucntion: freee
-    free( newNodePtr );
+    // unmap access file
+        // func: closeMetaDataFile
+    closeMetaDataFile( &mdFile );
 
-    // assign temporary local head pointer to parameter return pointer
-    *opCodeDataHead = localHeadPtr;
+    // assign local table pointer to parameter return pointer
+    *opTablePtr = localTablePtr;
 
     // return access result
     return accessResult;
@@ -174,7 +183,7 @@ int getOpCodes( char *fileName, OpCodeType **opCodeDataHead )
 Function Name:  getOpCommand
 Algorithm:      acquires one op command, verifies all parts of it,
                 returns as parameter
-Precondition:   file is open and file cursor is at beginning of an op code
+Precondition:   file is mapped and file cursor is at beginning of an op code
 Postcondition:  in correct operation, finds, tests, and returns op command as
                 parameter, and returns status as integer
                 - either complete op command found,
@@ -185,7 +194,7 @@ Exceptions:     correctly and appropriately (without program failure) responds
                 incorrect or out of range of command value
 Notes: none
  */
-int getOpCommand( FILE *filePtr, OpCodeType *inData )
+int getOpCommand( MetaDataFile *mdFile, OpCodeType *inData )
 {
     // initialize func/vars
 
@@ -205,8 +214,8 @@ int getOpCommand( FILE *filePtr, OpCodeType *inData )
         char strBuffer[ STD_STR_LEN ];
 
     //get whole op commadn as a string
-        // func: getLineTo
-    accessResult = getLineTo( filePtr, STD_STR_LEN, SEMICOLON,
+        // func: getMappedLineTo
+    accessResult = getMappedLineTo( mdFile, STD_STR_LEN, SEMICOLON,
                                         strBuffer, IGNORE_LEADING_WS );
 
     // check for successful access
@@ -283,6 +292,20 @@ int getOpCommand( FILE *filePtr, OpCodeType *inData )
         return CORRUPT_OPCMD_NAME_ERR;
     }
 
+    // find op kind for this letter and name combination
+        // func: getOpKind
+    inData->opKind = getOpKind( inData->opLtr, inData->opName );
+
+    // check for op name not used with this op letter
+    if( inData->opKind == NO_OP_KIND )
+    {
+        // set struct to null
+        inData = NULL;
+
+        // return corrupt op command found
+        return CORRUPT_OPCMD_NAME_ERR;
+    }
+
     // skip right paren element - increment source index, reset dest index
     sourceIndex++;
     destIndex = 0;
@@ -315,10 +338,12 @@ int getOpCommand( FILE *filePtr, OpCodeType *inData )
     // set value to data structure component
     inData->opValue = intBuffer;
 
+    // split memory op value into its segment fields now, not on each run
+        // function: decodeMemOperand
+    decodeMemOperand( inData->opKind, inData->opValue, &inData->memOperand );
+
     // check for last op command "S(end)0"
-        // func: compareString
-    if( inData->opLtr == 'S'
-            && compareString( inData->opName, "end" ) == STR_EQ )
+    if( inData->opKind == SYSTEM_END_OP )
     {
         // return last op command found message
         return LAST_OPCMD_FOUND_MSG;
@@ -327,6 +352,456 @@ int getOpCommand( FILE *filePtr, OpCodeType *inData )
     return COMPLETE_OPCMD_FOUND_MSG;
 }
 
+/*
+Function Name:  openMetaDataFile
+Algorithm:      opens file and maps its whole contents read only into memory,
+                sets file cursor to beginning of mapped data
+Precondition:   file name is valid C-Style string
+Postcondition:  in correct operation, meta data file struct holds the mapped
+                data and its size, returns NO_ERR
+Exceptions:     returns MD_FILE_ACCESS_ERR if file can not be opened or mapped;
+                an empty file is accepted with no mapped data
+Notes: file descriptor is closed once mapped, mapping stays valid
+ */
+int openMetaDataFile( char *fileName, MetaDataFile *mdFile )
+{
+    // initialize function/variables
+    int fileDesc;
+    struct stat fileStats;
+    void *mapPtr;
+
+    // initialize empty file
+    mdFile->data = NULL;
+    mdFile->size = 0;
+    mdFile->position = 0;
+
+    // open file for reading, find its size
+        // func: open, fstat
+    fileDesc = open( fileName, O_RDONLY );
+
+    if( fileDesc < 0 )
+    {
+        // return file access error
+        return MD_FILE_ACCESS_ERR;
+    }
+
+    if( fstat( fileDesc, &fileStats ) != 0 || !S_ISREG( fileStats.st_mode ) )
+    {
+        // close file, return file access error
+            // func: close
+        close( fileDesc );
+
+        return MD_FILE_ACCESS_ERR;
+    }
+
+    // check for data to map, mmap does not accept zero length
+    if( fileStats.st_size > 0 )
+    {
+        // map whole file, hint that it is read front to back
+            // func: mmap, posix_madvise
+        mapPtr = mmap( NULL, fileStats.st_size, PROT_READ, MAP_PRIVATE,
+                                                                fileDesc, 0 );
+
+        if( mapPtr == MAP_FAILED )
+        {
+            // close file, return file access error
+                // func: close
+            close( fileDesc );
+
+            return MD_FILE_ACCESS_ERR;
+        }
+
+        posix_madvise( mapPtr, fileStats.st_size, POSIX_MADV_SEQUENTIAL );
+
+        mdFile->data = ( char * ) mapPtr;
+        mdFile->size = ( long ) fileStats.st_size;
+    }
+
+    // mapping does not need the descriptor
+        // func: close
+    close( fileDesc );
+
+    return NO_ERR;
+}
+
+/*
+Function Name:  closeMetaDataFile
+Algorithm:      unmaps meta data file, resets struct to empty
+Precondition:   meta data file struct was set by openMetaDataFile
+Postcondition:  mapped memory is returned to OS
+Exceptions:     none
+Notes: none
+ */
+void closeMetaDataFile( MetaDataFile *mdFile )
+{
+    // check for mapped data
+    if( mdFile->data != NULL )
+    {
+        // unmap file
+            // func: munmap
+        munmap( mdFile->data, mdFile->size );
+    }
+
+    mdFile->data = NULL;
+    mdFile->size = 0;
+    mdFile->position = 0;
+}
+
+/*
+Function Name:  getMappedLineTo
+Algorithm:      finds stop character in mapped data from the file cursor,
+                skipping leading white space if specified, copies printable
+                characters before it to buffer, moves cursor past it
+Precondition:   meta data file is mapped, buffer has at least buffer size
+                characters available
+Postcondition:  ignores leading white space if specified;
+                captures all printable characters and stores in string buffer
+Exceptions:     returns INCOMPLETE_FILE_ERR if stop character is not found;
+                returns INPUT_BUFFER_OVERRUN_ERR if text does not fit buffer;
+                returns NO_ERR if successful operation
+Notes: same results as getLineTo, without a function call per character
+ */
+int getMappedLineTo( MetaDataFile *mdFile, int bufferSize, char stopChar,
+                                char *buffer, Boolean omitLeadingWhiteSpace )
+{
+    // initialize function/variables
+    unsigned char *dataPtr = ( unsigned char * ) mdFile->data;
+    long position = mdFile->position;
+    int charIndex = 0;
+    unsigned char *stopPtr;
+    unsigned char nextChar;
+
+    // set buffer to empty string in case of error
+    buffer[ charIndex ] = NULL_CHAR;
+
+    // consume leading white space, if flagged
+    while( omitLeadingWhiteSpace == True && position < mdFile->size
+              && dataPtr[ position ] != (unsigned char) stopChar
+                 && dataPtr[ position ] <= (unsigned char) SPACE )
+    {
+        position++;
+    }
+
+    // find stop character in remaining data
+        // func: memchr
+    stopPtr = NULL;
+
+    if( position < mdFile->size )
+    {
+        stopPtr = memchr( dataPtr + position, stopChar,
+                                                  mdFile->size - position );
+    }
+
+    if( stopPtr == NULL )
+    {
+        // move cursor to end, return incomplete file error
+        mdFile->position = mdFile->size;
+
+        return INCOMPLETE_FILE_ERR;
+    }
+
+    // capture printable characters up to stop character
+    while( dataPtr + position < stopPtr )
+    {
+        nextChar = dataPtr[ position ];
+
+        // check for usable (printable) character
+        if( nextChar >= (unsigned char) SPACE )
+        {
+            // check for end of buffer size
+            if( charIndex >= bufferSize - 1 )
+            {
+                mdFile->position = position;
+
+                return INPUT_BUFFER_OVERRUN_ERR;
+            }
+
+            buffer[ charIndex ] = (char) nextChar;
+            charIndex++;
+        }
+
+        position++;
+    }
+
+    // terminate string, move cursor past stop character
+    buffer[ charIndex ] = NULL_CHAR;
+    mdFile->position = position + 1;
+
+    return NO_ERR;
+}
+
+/*
+Function Name:  countOpCommands
+Algorithm:      counts op command separators in mapped data from the file
+                cursor to the end of the file
+Precondition:   meta data file is mapped
+Postcondition:  returns most op commands the rest of the file can hold,
+                file cursor is unchanged
+Exceptions:     none
+Notes: used to size the op table once before parsing
+ */
+int countOpCommands( MetaDataFile *mdFile )
+{
+    // initialize function/variables
+    char *searchPtr = mdFile->data + mdFile->position;
+    char *endPtr = mdFile->data + mdFile->size;
+    int count = 0;
+
+    // loop across each semicolon found
+        // func: memchr
+    while( searchPtr < endPtr
+            && ( searchPtr = memchr( searchPtr, SEMICOLON,
+                                            endPtr - searchPtr ) ) != NULL )
+    {
+        count++;
+        searchPtr++;
+    }
+
+    return count;
+}
+
+/*
+Function Name:  isMetaDataImage
+Algorithm:      checks mapped data for compiled image header
+Precondition:   meta data file is mapped
+Postcondition:  returns True if file starts with the image magic string,
+                otherwise returns False
+Exceptions:     none
+Notes: image version and contents are checked by loadOpTableImage
+ */
+Boolean isMetaDataImage( MetaDataFile *mdFile )
+{
+    // check for room for a header, and for magic string at the start
+        // func: memcmp
+    if( mdFile->size >= (long) sizeof( MetaDataImageHeader )
+        && memcmp( mdFile->data, MD_IMAGE_MAGIC, sizeof( MD_IMAGE_MAGIC ) )
+                                                                        == 0 )
+    {
+        return True;
+    }
+
+    return False;
+}
+
+/*
+Function Name:  loadOpTableImage
+Algorithm:      checks compiled image header, size and checksum, then points
+                op table arrays into the mapped image
+Precondition:   meta data file is mapped and isMetaDataImage is True
+Postcondition:  in correct operation, returns op table through parameter,
+                op table keeps the mapping and file struct is set to empty
+Exceptions:     returns MD_CORRUPT_IMAGE_ERR for an image of another version,
+                of the wrong size, with a bad checksum, or with a process
+                range outside the op table
+Notes: only the time remaining array is allocated, nothing is parsed
+ */
+int loadOpTableImage( MetaDataFile *mdFile, OpTable **opTablePtr )
+{
+    // initialize function/variables
+    MetaDataImageHeader *imageHeader = ( MetaDataImageHeader * ) mdFile->data;
+    char *dataPtr = mdFile->data + sizeof( MetaDataImageHeader );
+    int numOps = imageHeader->numOps;
+    int numProcesses = imageHeader->numProcesses;
+    long expectedSize;
+    int procIndex;
+    OpTable *opTable;
+
+    // intialize op table pointer in case of return error
+    *opTablePtr = NULL;
+
+    // check version and counts before using them for sizes
+    if( imageHeader->version != MD_IMAGE_VERSION
+                                    || numOps < 1 || numProcesses < 0 )
+    {
+        return MD_CORRUPT_IMAGE_ERR;
+    }
+
+    // check file holds exactly the arrays named in the header
+        // func: getImagePadding
+    expectedSize = (long) sizeof( MetaDataImageHeader ) + numOps
+                        + getImagePadding( numOps )
+                        + (long) sizeof( int ) * ( numOps + 4L * numProcesses )
+                        + (long) sizeof( MemOperand ) * numOps;
+
+    if( mdFile->size != expectedSize
+        || updateImageChecksum( 0, dataPtr,
+                            expectedSize - sizeof( MetaDataImageHeader ) )
+                                                    != imageHeader->checksum )
+    {
+        return MD_CORRUPT_IMAGE_ERR;
+    }
+
+    // set up op table over the image arrays
+        // func: malloc
+    opTable = ( OpTable * ) malloc( sizeof( OpTable ) );
+    opTable->numOps = numOps;
+    opTable->numProcesses = numProcesses;
+    opTable->procCapacity = numProcesses;
+
+    opTable->opKind = ( unsigned char * ) dataPtr;
+    dataPtr += numOps + getImagePadding( numOps );
+    opTable->opValue = ( int * ) dataPtr;
+    opTable->procStart = opTable->opValue + numOps;
+    opTable->procEnd = opTable->procStart + numProcesses;
+    opTable->procCycles = opTable->procEnd + numProcesses;
+    opTable->ioCycles = opTable->procCycles + numProcesses;
+    opTable->memOperand = ( MemOperand * ) ( opTable->ioCycles + numProcesses );
+
+    // time remaining is set before each run, so it is not in the image
+    opTable->timeRemaining = ( int * ) malloc( numOps * sizeof( int ) );
+
+    // op table now owns the mapping
+    opTable->mapData = mdFile->data;
+    opTable->mapSize = mdFile->size;
+    mdFile->data = NULL;
+    mdFile->size = 0;
+
+    // check process ranges, they are used as op table indices
+    for( procIndex = 0; procIndex < numProcesses; procIndex++ )
+    {
+        if( opTable->procStart[ procIndex ] < 0
+            || opTable->procStart[ procIndex ] > opTable->procEnd[ procIndex ]
+            || opTable->procEnd[ procIndex ] >= numOps )
+        {
+            // release table and mapping
+                // func: clearOpTable
+            clearOpTable( opTable );
+
+            return MD_CORRUPT_IMAGE_ERR;
+        }
+    }
+
+    *opTablePtr = opTable;
+
+    return NO_ERR;
+}
+
+/*
+Function Name:  writeOpTableImage
+Algorithm:      writes image header with checksum, then each op table
+                array, to a new file
+Precondition:   op table was loaded without error and has process totals
+Postcondition:  in correct operation, image file can be loaded by getOpCodes
+                in place of the meta data file, returns NO_ERR
+Exceptions:     returns MD_FILE_ACCESS_ERR if file can not be written
+Notes: image uses this machine's byte order and int size
+ */
+int writeOpTableImage( char *fileName, OpTable *opTable )
+{
+    // initialize function/variables
+    const char WRITE_BINARY_FLAG[] = "wb";
+    char padding[ 4 ] = { 0, 0, 0, 0 };
+    int numOps = opTable->numOps;
+    int numProcesses = opTable->numProcesses;
+    int padCount = getImagePadding( numOps );
+    MetaDataImageHeader imageHeader;
+    unsigned int checksum = 0;
+    Boolean writeOk = True;
+    FILE *filePtr;
+
+    // add up checksum of all bytes that follow the header
+        // func: updateImageChecksum
+    checksum = updateImageChecksum( checksum,
+                                    ( char * ) opTable->opKind, numOps );
+    checksum = updateImageChecksum( checksum, padding, padCount );
+    checksum = updateImageChecksum( checksum, ( char * ) opTable->opValue,
+                                                    numOps * sizeof( int ) );
+    checksum = updateImageChecksum( checksum, ( char * ) opTable->procStart,
+                                              numProcesses * sizeof( int ) );
+    checksum = updateImageChecksum( checksum, ( char * ) opTable->procEnd,
+                                              numProcesses * sizeof( int ) );
+    checksum = updateImageChecksum( checksum, ( char * ) opTable->procCycles,
+                                              numProcesses * sizeof( int ) );
+    checksum = updateImageChecksum( checksum, ( char * ) opTable->ioCycles,
+                                              numProcesses * sizeof( int ) );
+    checksum = updateImageChecksum( checksum, ( char * ) opTable->memOperand,
+                                            numOps * sizeof( MemOperand ) );
+
+    // set header
+        // func: memset, memcpy
+    memset( &imageHeader, 0, sizeof( MetaDataImageHeader ) );
+    memcpy( imageHeader.magic, MD_IMAGE_MAGIC, sizeof( MD_IMAGE_MAGIC ) );
+    imageHeader.version = MD_IMAGE_VERSION;
+    imageHeader.numOps = numOps;
+    imageHeader.numProcesses = numProcesses;
+    imageHeader.checksum = checksum;
+
+    // open file for writing
+        // func: fopen
+    filePtr = fopen( fileName, WRITE_BINARY_FLAG );
+
+    if( filePtr == NULL )
+    {
+        return MD_FILE_ACCESS_ERR;
+    }
+
+    // write header and arrays, in image order
+        // func: fwrite
+    writeOk = fwrite( &imageHeader, sizeof( MetaDataImageHeader ), 1,
+                                                              filePtr ) == 1
+        && fwrite( opTable->opKind, 1, numOps, filePtr ) == (size_t) numOps
+        && fwrite( padding, 1, padCount, filePtr ) == (size_t) padCount
+        && fwrite( opTable->opValue, sizeof( int ), numOps, filePtr )
+                                                          == (size_t) numOps
+        && fwrite( opTable->procStart, sizeof( int ), numProcesses, filePtr )
+                                                    == (size_t) numProcesses
+        && fwrite( opTable->procEnd, sizeof( int ), numProcesses, filePtr )
+                                                    == (size_t) numProcesses
+        && fwrite( opTable->procCycles, sizeof( int ), numProcesses, filePtr )
+                                                    == (size_t) numProcesses
+        && fwrite( opTable->ioCycles, sizeof( int ), numProcesses, filePtr )
+                                                    == (size_t) numProcesses
+        && fwrite( opTable->memOperand, sizeof( MemOperand ), numOps, filePtr )
+                                                          == (size_t) numOps;
+
+    // close file, check for any failed write
+        // func: fclose
+    if( fclose( filePtr ) != 0 || writeOk == False )
+    {
+        return MD_FILE_ACCESS_ERR;
+    }
+
+    return NO_ERR;
+}
+
+/*
+Function Name:  getImagePadding
+Algorithm:      finds bytes needed after op kinds to align the int arrays
+Precondition:   number of ops >= 0
+Postcondition:  returns padding byte count, 0 to 3
+Exceptions:     none
+Notes: none
+ */
+int getImagePadding( int numOps )
+{
+    return ( 4 - numOps % 4 ) % 4;
+}
+
+/*
+Function Name:  updateImageChecksum
+Algorithm:      adds bytes to 32 bit FNV-1a checksum
+Precondition:   checksum is 0 or result of previous update
+Postcondition:  returns updated checksum
+Exceptions:     none
+Notes: start value 0 is used in place of the FNV offset basis
+ */
+unsigned int updateImageChecksum( unsigned int checksum,
+                                            char *bytes, long byteCount )
+{
+    // initialize function/variables
+    const unsigned int FNV_PRIME = 16777619u;
+    long index;
+
+    // loop across bytes
+    for( index = 0; index < byteCount; index++ )
+    {
+        checksum ^= ( unsigned char ) bytes[ index ];
+        checksum *= FNV_PRIME;
+    }
+
+    return checksum;
+}
+
 /*
 Function Name:  updateStartCount
 Algorithm:      updates number of "start" op commands found in file
@@ -374,41 +849,153 @@ int updateEndCount( int count, char *opString )
 }
 
 /*
-Function Name:  addNode
-Algorithm:      adds op command structure with data to a linked list
-Precondition:   linked list pointer assigned to null or to one op command link,
-                struct pointer assigned to op command struct data
-Postcondition:  assigns new structure node to beginning of linked list
-                or end of established linked list
+Function Name:  createOpTable
+Algorithm:      allocates empty op table with room for given number of ops
+Precondition:   op capacity >= 0
+Postcondition:  returns pointer to op table with no ops or processes
+Exceptions:     none
+Notes: assumes memory access/availability
+ */
+OpTable *createOpTable( int opCapacity )
+{
+    // initialize function/variables
+    OpTable *opTable;
+
+    // access memory for table and its op arrays, at least one op each
+        // func: malloc
+    if( opCapacity < 1 )
+    {
+        opCapacity = 1;
+    }
+
+    opTable = ( OpTable * ) malloc( sizeof( OpTable ) );
+    opTable->numOps = 0;
+    opTable->opKind = ( unsigned char * ) malloc( opCapacity );
+    opTable->opValue = ( int * ) malloc( opCapacity * sizeof( int ) );
+    opTable->timeRemaining = ( int * ) malloc( opCapacity * sizeof( int ) );
+    opTable->memOperand = ( MemOperand * ) malloc( opCapacity
+                                                    * sizeof( MemOperand ) );
+
+    // start process ranges small, they grow as A(start) ops are added
+    opTable->numProcesses = 0;
+    opTable->procCapacity = 1;
+    opTable->procStart = ( int * ) malloc( sizeof( int ) );
+    opTable->procEnd = ( int * ) malloc( sizeof( int ) );
+
+    // process totals are set once all processes are found
+    opTable->procCycles = NULL;
+    opTable->ioCycles = NULL;
+
+    // table arrays are not in a compiled image
+    opTable->mapData = NULL;
+    opTable->mapSize = 0;
+
+    return opTable;
+}
+
+/*
+Function Name:  addOpToTable
+Algorithm:      copies op command to the next op table entry;
+                an A(start) op also begins a new process range
+Precondition:   op table has room for another op, new op passed validation
+Postcondition:  op is stored at index numOps - 1, new process range end is
+                left unset until closeOpenProcesses
+Exceptions:     none
+Notes: assumes memory access/availability; process arrays double as needed
+ */
+void addOpToTable( OpTable *opTable, OpCodeType *newOp )
+{
+    // initialize function/variables
+    int opIndex = opTable->numOps;
+
+    // assign op kind and value, time is set before a run
+    opTable->opKind[ opIndex ] = ( unsigned char ) newOp->opKind;
+    opTable->opValue[ opIndex ] = newOp->opValue;
+    opTable->timeRemaining[ opIndex ] = 0;
+    opTable->memOperand[ opIndex ] = newOp->memOperand;
+    opTable->numOps++;
+
+    // check for start of a process
+    if( newOp->opKind == APP_START_OP )
+    {
+        // check for full process arrays, double them
+            // func: realloc
+        if( opTable->numProcesses == opTable->procCapacity )
+        {
+            opTable->procCapacity *= 2;
+            opTable->procStart = ( int * ) realloc( opTable->procStart,
+                                      opTable->procCapacity * sizeof( int ) );
+            opTable->procEnd = ( int * ) realloc( opTable->procEnd,
+                                      opTable->procCapacity * sizeof( int ) );
+        }
+
+        opTable->procStart[ opTable->numProcesses ] = opIndex;
+        opTable->procEnd[ opTable->numProcesses ] = opIndex;
+        opTable->numProcesses++;
+    }
+}
+
+/*
+Function Name:  closeOpenProcesses
+Algorithm:      sets end index of every process that does not have one yet
+Precondition:   first open process is the lowest process without an end,
+                end index is an A(end) or the final S(end) op
+Postcondition:  all processes end at or before end index,
+                first open process is set past the last process
+Exceptions:     none
+Notes: a process runs to the first A(end) after its A(start)
+ */
+void closeOpenProcesses( OpTable *opTable, int *firstOpenProc, int endIndex )
+{
+    // loop across processes started since the last A(end)
+    while( *firstOpenProc < opTable->numProcesses )
+    {
+        opTable->procEnd[ *firstOpenProc ] = endIndex;
+        ( *firstOpenProc )++;
+    }
+}
+
+/*
+Function Name:  setProcessTotals
+Algorithm:      adds up P(run) and I/O cycles in each process's op range
+Precondition:   all process ranges are closed
+Postcondition:  process cycle and I/O cycle arrays hold each process total
 Exceptions:     none
 Notes: assumes memory access/availability
  */
-OpCodeType *addNode( OpCodeType *localPtr, OpCodeType *newNode )
+void setProcessTotals( OpTable *opTable )
 {
-    // check for local ptr assigned to null
-    if( localPtr == NULL )
-    {
-        // access memory for new link/node
-            // func: malloc
-        localPtr = ( OpCodeType * ) malloc( sizeof( OpCodeType ) );
-        // assign all three values to newly created node
-        // assign next pointer to null
-            // func: copyString
-        localPtr->opLtr = newNode->opLtr;
-        copyString( localPtr->opName, newNode->opName );
-        localPtr->opValue = newNode->opValue;
-        localPtr->next = NULL;
-
-        // return current local pointer
-        return localPtr;
-    }
-    // assume end of list not found yet
-    // assign recursive function to current's next link
-        // function: addNode
-    localPtr->next = addNode( localPtr->next, newNode );
-
-    // return current local pointer
-    return localPtr;
+    // initialize function/variables
+    int procIndex, opIndex;
+
+    // access memory for totals, at least one each
+        // func: malloc
+    opTable->procCycles = ( int * ) malloc( opTable->procCapacity
+                                                            * sizeof( int ) );
+    opTable->ioCycles = ( int * ) malloc( opTable->procCapacity
+                                                            * sizeof( int ) );
+
+    // loop across processes
+    for( procIndex = 0; procIndex < opTable->numProcesses; procIndex++ )
+    {
+        opTable->procCycles[ procIndex ] = 0;
+        opTable->ioCycles[ procIndex ] = 0;
+
+        // loop across ops between A(start) and A(end)
+        for( opIndex = opTable->procStart[ procIndex ] + 1;
+                        opIndex < opTable->procEnd[ procIndex ]; opIndex++ )
+        {
+            if( opTable->opKind[ opIndex ] == PROCESS_RUN_OP )
+            {
+                opTable->procCycles[ procIndex ] += opTable->opValue[ opIndex ];
+            }
+
+            else if( isIoOp( opTable->opKind[ opIndex ] ) == True )
+            {
+                opTable->ioCycles[ procIndex ] += opTable->opValue[ opIndex ];
+            }
+        }
+    }
 }
 
 /*
@@ -444,6 +1031,152 @@ Boolean checkOpString( char *testStr )
     return False;
 }
 
+/*
+Function Name:  getOpKind
+Algorithm:      finds op kind for op letter and op name combination
+Precondition:   op name is a valid op command name
+Postcondition:  returns op kind code, or NO_OP_KIND if the op letter is
+                not used with the op name
+Exceptions:     none
+Notes: codes match opKindToLetter and opKindToString
+ */
+int getOpKind( char opLtr, char *opName )
+{
+    // initialize function/variables
+    int opKind;
+    char kindName[ STD_STR_LEN ];
+
+    // loop across op kinds
+    for( opKind = SYSTEM_START_OP; opKind < NO_OP_KIND; opKind++ )
+    {
+        // check for matching letter, then matching name
+            // func: opKindToLetter, opKindToString, compareString
+        if( opKindToLetter( opKind ) == opLtr )
+        {
+            opKindToString( opKind, kindName );
+
+            if( compareString( opName, kindName ) == STR_EQ )
+            {
+                // return op kind
+                return opKind;
+            }
+        }
+    }
+
+    // return not found
+    return NO_OP_KIND;
+}
+
+/*
+Function Name:  decodeMemOperand
+Algorithm:      splits an M op value into segment id, base and offset
+Precondition:   op value has passed validation, at most eight digits
+Postcondition:  memory operand holds the decoded fields for an allocate
+                or access op, and zeros for any other op
+Exceptions:     none
+Notes: values have at most eight digits, so an id is at most 99
+ */
+void decodeMemOperand( int opKind, int opValue, MemOperand *memOperand )
+{
+    // clear fields, other ops have no memory operand
+        // func: memset
+    memset( memOperand, 0, sizeof( MemOperand ) );
+
+    // check for memory op, split value
+    if( opKind == MEM_ALLOCATE_OP || opKind == MEM_ACCESS_OP )
+    {
+        memOperand->id = ( unsigned char ) ( opValue / 1000000 );
+        memOperand->base = ( unsigned short ) ( ( opValue / 1000 ) % 1000 );
+        memOperand->offset = ( unsigned short ) ( opValue % 1000 );
+    }
+}
+
+/*
+Function Name:  isIoOp
+Algorithm:      checks op kind for an input or output op
+Precondition:   code is an op kind code
+Postcondition:  returns True for I and O op kinds, otherwise returns False
+Exceptions:     none
+Notes: I/O op kinds are listed together in OpKindCode
+ */
+Boolean isIoOp( int opKind )
+{
+    if( opKind >= INPUT_HARD_DRIVE_OP && opKind <= OUTPUT_MONITOR_OP )
+    {
+        return True;
+    }
+
+    return False;
+}
+
+/*
+Function Name:  getIoDevice
+Algorithm:      finds device used by an input or output op kind
+Precondition:   op kind is an I/O op kind
+Postcondition:  returns I/O device code
+Exceptions:     none
+Notes: input and output op kinds list devices in IoDeviceCodes order
+ */
+int getIoDevice( int opKind )
+{
+    return ( opKind - INPUT_HARD_DRIVE_OP ) % NUM_IO_DEVICES;
+}
+
+/*
+Function Name:  ioDeviceToString
+Algorithm:      utility function to convert I/O device code to its name
+Precondition:   code is an I/O device code
+Postcondition:  string parameter holds device name, as used in op commands
+Exceptions:     none
+Notes: none
+ */
+void ioDeviceToString( int device, char *outString )
+{
+    // func: opKindToString
+    opKindToString( INPUT_HARD_DRIVE_OP + device, outString );
+}
+
+/*
+Function Name:  opKindToLetter
+Algorithm:      utility function to find op command letter of op kind
+Precondition:   code is an op kind code
+Postcondition:  returns op letter
+Exceptions:     none
+Notes: none
+ */
+char opKindToLetter( int opKind )
+{
+    // Define array with one letter per op kind
+    char opLetters[] = { 'S', 'S', 'A', 'A', 'P', 'M', 'M',
+                         'I', 'I', 'I', 'I', 'O', 'O', 'O', 'O' };
+
+    // return letter
+    return opLetters[ opKind ];
+}
+
+/*
+Function Name:  opKindToString
+Algorithm:      utility function to convert op kind back to its op name
+Precondition:   code is an op kind code
+Postcondition:  string parameter holds op name
+Exceptions:     none
+Notes: none
+ */
+void opKindToString( int opKind, char *outString )
+{
+    // Define array with fifteen items, and short (11) lengths
+    char opNames[ 15 ][ 11 ] = { "start", "end", "start", "end", "run",
+                                 "allocate", "access",
+                                 "hard drive", "keyboard", "printer",
+                                 "monitor",
+                                 "hard drive", "keyboard", "printer",
+                                 "monitor" };
+
+    // copy string to return parameter
+        // func: copyString
+    copyString( outString, opNames[ opKind ] );
+}
+
 /*
 Function Name:  isDigit
 Algorithm:      checks for character digit, returns result
@@ -468,37 +1201,40 @@ Boolean isDigit( char testChar )
 
 /*
 Function Name:  displayMetaData
-Algorithm:      iterates through op code linked list,
+Algorithm:      iterates through op table,
                 displays op code data individually
-Precondition:   linked list, with or without data
+Precondition:   op table, with or without data
                 (should not be called if no data)
-Postcondition:  displays all op codes in list
+Postcondition:  displays all op codes in table
 Exceptions:     none
 Notes: none
  */
-void displayMetaData( OpCodeType *localPtr )
+void displayMetaData( OpTable *opTable )
 {
+    // initialize function/variables
+    int opIndex;
+    char opName[ STD_STR_LEN ];
+
     // display title, with underline
         // func: printf
     printf( "\nMeta-Data File Display\n" );
     printf( "======================\n\n" );
-    // loop to end of linked list
-    while( localPtr != NULL )
+    // loop to end of op table
+    for( opIndex = 0; opIndex < opTable->numOps; opIndex++ )
     {
         // print op code letter
-            // func: printf
-        printf( "Op code letter: %c\n", localPtr->opLtr );
+            // func: printf, opKindToLetter
+        printf( "Op code letter: %c\n",
+                            opKindToLetter( opTable->opKind[ opIndex ] ) );
 
         // print op code name
-            // func: printf
-        printf( "Op code name: %s\n", localPtr->opName );
+            // func: printf, opKindToString
+        opKindToString( opTable->opKind[ opIndex ], opName );
+        printf( "Op code name: %s\n", opName );
 
         // print op code value
             // func: printf
-        printf( "Op code value: %d\n\n", localPtr->opValue);
-
-        // assign local pointer to next node
-        localPtr = localPtr->next;
+        printf( "Op code value: %d\n\n", opTable->opValue[ opIndex ] );
     }
 }
 
@@ -513,9 +1249,9 @@ Notes: none
  */
 void displayMetaDataError( int code )
 {
-    // create string error list, 10 items, max 35 letters
+    // create string error list, 11 items, max 35 letters
     // includes 3 errors from StringManipError
-    char errorList[ 10 ][ 35 ] =
+    char errorList[ 11 ][ 35 ] =
                     { "No Error",
                       "Incomplete File Error",
                       "Input Buffer Overrun",
@@ -525,7 +1261,8 @@ void displayMetaDataError( int code )
                       "Corrupt Op Command Letter Error",
                       "Corrupt Op Command Name Error",
                       "Corrupt Op Command Value Error",
-                      "Unbalanced Start-End Code Error" };
+                      "Unbalanced Start-End Code Error",
+                      "MD Corrupt Binary Image Error" };
 
     // display error to monitor with selected error string
         // func: printf
@@ -533,39 +1270,45 @@ void displayMetaDataError( int code )
 }
 
 /*
-Function Name:  clearMetaDataList
-Algorithm:      recursively iterates through op code linked list,
-                returns memory to OS from the bottom of the list upward
-Precondition:   linked list, with or without data
-Postcondition:  all node memory, if any, is returned to OS,
-                reutrn pointer (head) is set to null
+Function Name:  clearOpTable
+Algorithm:      returns op table arrays and table memory to OS
+Precondition:   op table pointer, or null for no table
+Postcondition:  all table memory, if any, is returned to OS,
+                reutrn pointer is set to null
 Exceptions:     none
 Notes: none
  */
-OpCodeType *clearMetaDataList( OpCodeType *localPtr )
+OpTable *clearOpTable( OpTable *opTable )
 {
-    // check for local pointer not set to null (list not empty)
-    if( localPtr != NULL )
+    // check for table not set to null
+    if( opTable != NULL )
     {
-        // check for lcoal pointer's next node not null
-        if( localPtr->next != NULL )
+        // check for arrays in a compiled image, unmap it
+            // func: munmap
+        if( opTable->mapData != NULL )
         {
-            // call recursive function with next pointer
-                // func: clearMetaDataList
-            clearMetaDataList( localPtr->next );
+            munmap( opTable->mapData, opTable->mapSize );
         }
 
-        // after recursive call, release memory to OS
+        // otherwise, release array memory to OS
             // func: free
-        free( localPtr );
+        else
+        {
+            free( opTable->opKind );
+            free( opTable->opValue );
+            free( opTable->procStart );
+            free( opTable->procEnd );
+            free( opTable->procCycles );
+            free( opTable->ioCycles );
+            free( opTable->memOperand );
+        }
+
+        // release memory to OS
+            // func: free
+        free( opTable->timeRemaining );
+        free( opTable );
     }
 
     // return null to calling function
     return NULL;
 }
-
-
-
-
-
-
@@ -8,6 +8,10 @@
 
 //global constants
 
+// constants identifying compiled meta data image files
+extern const char MD_IMAGE_MAGIC[];
+extern const int MD_IMAGE_VERSION;
+
 typedef enum {  MD_FILE_ACCESS_ERR = 3,
                 MD_CORRUPT_DESCRIPTOR_ERR,
                 OPCMD_ACCESS_ERR,
@@ -15,31 +19,128 @@ typedef enum {  MD_FILE_ACCESS_ERR = 3,
                 CORRUPT_OPCMD_NAME_ERR,
                 CORRUPT_OPCMD_VALUE_ERR,
                 UNBALANCED_START_END_ERR,
+                MD_CORRUPT_IMAGE_ERR,
                 COMPLETE_OPCMD_FOUND_MSG,
                 LAST_OPCMD_FOUND_MSG } OpCodeMessages;
 
-// op code data structure
+// op kinds, one for each valid op letter and op name combination,
+// stored in one byte per op in the op table
+typedef enum {  SYSTEM_START_OP,
+                SYSTEM_END_OP,
+                APP_START_OP,
+                APP_END_OP,
+                PROCESS_RUN_OP,
+                MEM_ALLOCATE_OP,
+                MEM_ACCESS_OP,
+                INPUT_HARD_DRIVE_OP,
+                INPUT_KEYBOARD_OP,
+                INPUT_PRINTER_OP,
+                INPUT_MONITOR_OP,
+                OUTPUT_HARD_DRIVE_OP,
+                OUTPUT_KEYBOARD_OP,
+                OUTPUT_PRINTER_OP,
+                OUTPUT_MONITOR_OP,
+                NO_OP_KIND } OpKindCode;
+
+// I/O devices, in the same order as the input and output op kinds
+typedef enum {  HARD_DRIVE_DEVICE,
+                KEYBOARD_DEVICE,
+                PRINTER_DEVICE,
+                MONITOR_DEVICE,
+                NUM_IO_DEVICES } IoDeviceCodes;
+
+// segment id, base and offset of an M op, decoded from its value
+// ( id * 1000000 + base * 1000 + offset ) once, when it is parsed;
+// zero for other ops
+typedef struct
+{
+    unsigned short base;
+    unsigned short offset;
+    unsigned char id;
+    unsigned char reserved;
+} MemOperand;
+
+// op code data structure, holds one op command while it is parsed
 typedef struct OpCodeType
 {
     char opLtr;
     char opName[ 100 ];  // length of op name - 99 characters
     int opValue;
-    int timeRemaining;
-
-    struct OpCodeType *next;
+    int opKind;
+    MemOperand memOperand;
 } OpCodeType;
 
+// op table, parallel arrays indexed by position in meta data file,
+// with each process stored as the op index range of its A(start)/A(end)
+typedef struct
+{
+    int numOps;
+    unsigned char *opKind;
+    int *opValue;
+    int *timeRemaining;     // msec, set from cycle times before a run
+    MemOperand *memOperand;
+    int numProcesses;
+    int procCapacity;
+    int *procStart;
+    int *procEnd;
+    int *procCycles;        // total P(run) cycles of each process
+    int *ioCycles;          // total I/O cycles of each process
+    char *mapData;          // compiled image the arrays point into, if any
+    long mapSize;
+} OpTable;
+
+// compiled meta data image header, followed by the op kind bytes padded
+// to a multiple of four, then op values, process starts, process ends,
+// process cycles and I/O cycles as int arrays, then the memory operands
+typedef struct
+{
+    char magic[ 8 ];
+    int version;
+    int numOps;
+    int numProcesses;
+    unsigned int checksum;  // of all bytes after the header
+} MetaDataImageHeader;
+
+// read only view of a memory mapped meta data file
+typedef struct
+{
+    char *data;
+    long size;
+    long position;      // file cursor, index of next unread character
+} MetaDataFile;
+
 //function prototypes
-int getOpCodes( char *fileName, OpCodeType **opCodeDataHead );
-int getOpCommand( FILE *filePtr, OpCodeType *inData );
+int getOpCodes( char *fileName, OpTable **opTablePtr );
+int getOpCommand( MetaDataFile *mdFile, OpCodeType *inData );
+int openMetaDataFile( char *fileName, MetaDataFile *mdFile );
+void closeMetaDataFile( MetaDataFile *mdFile );
+int getMappedLineTo( MetaDataFile *mdFile, int bufferSize, char stopChar,
+                                char *buffer, Boolean omitLeadingWhiteSpace );
+int countOpCommands( MetaDataFile *mdFile );
+Boolean isMetaDataImage( MetaDataFile *mdFile );
+int loadOpTableImage( MetaDataFile *mdFile, OpTable **opTablePtr );
+int writeOpTableImage( char *fileName, OpTable *opTable );
+int getImagePadding( int numOps );
+unsigned int updateImageChecksum( unsigned int checksum,
+                                            char *bytes, long byteCount );
 int updateStartCount( int count, char *opString );
 int updateEndCount( int count, char *opString );
-OpCodeType *addNode( OpCodeType *localPtr, OpCodeType *newNode );
+OpTable *createOpTable( int opCapacity );
+void addOpToTable( OpTable *opTable, OpCodeType *newOp );
+void closeOpenProcesses( OpTable *opTable, int *firstOpenProc, int endIndex );
+void setProcessTotals( OpTable *opTable );
 Boolean checkOpString( char *testStr );
+int getOpKind( char opLtr, char *opName );
+void decodeMemOperand( int opKind, int opValue, MemOperand *memOperand );
+Boolean isIoOp( int opKind );
+int getIoDevice( int opKind );
+void ioDeviceToString( int device, char *outString );
+char opKindToLetter( int opKind );
+void opKindToString( int opKind, char *outString );
 Boolean isDigit( char testChar );
-void displayMetaData( OpCodeType *localPtr );
+void displayMetaData( OpTable *opTable );
 void displayMetaDataError( int code );
-OpCodeType *clearMetaDataList( OpCodeType *localPtr );
+OpTable *clearOpTable( OpTable *opTable );
 
 
 #endif // META_DATA_ACCESS_H
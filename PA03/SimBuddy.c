@@ -0,0 +1,265 @@
+// Header files
+#include "SimBuddy.h"
+
+// address of no block, also ends the free lists
+const int NO_BLOCK = -1;
+
+// Buddy allocator ///////////////////////////////////////////////////////////
+
+// Memory Available (KB) is split into power of two blocks, largest
+// first, so a pool of any size is covered and every block starts at a
+// multiple of its own size. An allocation takes the smallest free block
+// big enough, halving it until it fits the request; a freed block joins
+// its buddy, the block its address differs from in the bit of its size,
+// for as long as that buddy is free and whole. Both walk at most one
+// step per order, O(log n) in the pool size.
+
+/**
+ * @brief Sets up a pool of free memory.
+ *
+ * @param[out] pool Pool to set up
+ *
+ * @param[in] totalKB Size of the pool in KB
+ *
+ * @return none
+ */
+void createBuddyPool(BuddyPool *pool, int totalKB)
+{
+    int units = totalKB > 0 ? totalKB : 1;
+    int order, block;
+
+    pool->totalKB = totalKB;
+    pool->freeKB = 0;
+    pool->maxOrder = 0;
+
+    while(pool->maxOrder < 30 && (1 << (pool->maxOrder + 1)) <= totalKB)
+    {
+        pool->maxOrder++;
+    }
+
+    pool->freeHeads = (int *)malloc((pool->maxOrder + 1) * sizeof(int));
+    pool->nextFree = (int *)malloc(units * sizeof(int));
+    pool->prevFree = (int *)malloc(units * sizeof(int));
+    pool->blockOrder = (unsigned char *)malloc(units);
+    pool->blockState = (unsigned char *)calloc(units, 1);
+
+    for(order = 0; order <= pool->maxOrder; order++)
+    {
+        pool->freeHeads[order] = NO_BLOCK;
+    }
+
+    // one free block for each bit set in the size, largest first
+    block = 0;
+
+    for(order = pool->maxOrder; order >= 0; order--)
+    {
+        if((totalKB & (1 << order)) != 0)
+        {
+            addFreeBlock(pool, block, order);
+            block += 1 << order;
+        }
+    }
+
+    pool->stats = (BuddyStats){ 0, 0, 0, 0 };
+}
+
+/**
+ * @brief Frees a pool's tables.
+ *
+ * @param[in,out] pool Pool to free
+ *
+ * @return none
+ */
+void freeBuddyPool(BuddyPool *pool)
+{
+    free(pool->freeHeads);
+    free(pool->nextFree);
+    free(pool->prevFree);
+    free(pool->blockOrder);
+    free(pool->blockState);
+}
+
+/**
+ * @brief Allocates a block of at least the given size.
+ *
+ * @param[in,out] pool Pool to allocate from
+ *
+ * @param[in] sizeKB KB asked for, at least 1
+ *
+ * @return Address of the block in KB, NO_BLOCK when no free block is
+ *         big enough
+ */
+int allocBuddyBlock(BuddyPool *pool, int sizeKB)
+{
+    int order = getBlockOrder(sizeKB);
+    int freeOrder = order;
+    int block;
+
+    while(freeOrder <= pool->maxOrder && pool->freeHeads[freeOrder] == NO_BLOCK)
+    {
+        freeOrder++;
+    }
+
+    if(freeOrder > pool->maxOrder)
+    {
+        pool->stats.failures++;
+
+        return NO_BLOCK;
+    }
+
+    block = pool->freeHeads[freeOrder];
+    removeFreeBlock(pool, block, freeOrder);
+
+    // give back the upper half until the block is the size wanted
+    while(freeOrder > order)
+    {
+        freeOrder--;
+        addFreeBlock(pool, block + (1 << freeOrder), freeOrder);
+    }
+
+    pool->blockOrder[block] = (unsigned char)order;
+    pool->blockState[block] = BLOCK_USED;
+    pool->stats.allocations++;
+
+    return block;
+}
+
+/**
+ * @brief Frees a block, joining it with its free buddies.
+ *
+ * @param[in,out] pool Pool the block is from
+ *
+ * @param[in] block Address of an allocated block
+ *
+ * @return none
+ */
+void freeBuddyBlock(BuddyPool *pool, int block)
+{
+    int order = pool->blockOrder[block];
+    int buddy;
+
+    pool->stats.frees++;
+    pool->blockState[block] = BLOCK_NONE;
+
+    while(order < pool->maxOrder)
+    {
+        buddy = block ^ (1 << order);
+
+        if(buddy >= pool->totalKB || pool->blockState[buddy] != BLOCK_FREE
+                                        || pool->blockOrder[buddy] != order)
+        {
+            break;
+        }
+
+        removeFreeBlock(pool, buddy, order);
+        pool->blockState[buddy] = BLOCK_NONE;
+
+        if(buddy < block)
+        {
+            block = buddy;
+        }
+
+        order++;
+        pool->stats.merges++;
+    }
+
+    addFreeBlock(pool, block, order);
+}
+
+/**
+ * @brief Finds the order of the smallest block holding a size.
+ *
+ * @param[in] sizeKB Size in KB
+ *
+ * @return Order of the block
+ */
+int getBlockOrder(int sizeKB)
+{
+    int order = 0;
+
+    while((1 << order) < sizeKB)
+    {
+        order++;
+    }
+
+    return order;
+}
+
+/**
+ * @brief Finds the size of the largest free block.
+ *
+ * @param[in] pool Pool to look in
+ *
+ * @return Size in KB, 0 when nothing is free
+ */
+int getLargestFreeKB(BuddyPool *pool)
+{
+    int order;
+
+    for(order = pool->maxOrder; order >= 0; order--)
+    {
+        if(pool->freeHeads[order] != NO_BLOCK)
+        {
+            return 1 << order;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Pushes a free block on the list of its order.
+ *
+ * @param[in,out] pool Pool the block is in
+ *
+ * @param[in] block Address of the block
+ *
+ * @param[in] order Order of the block
+ *
+ * @return none
+ */
+void addFreeBlock(BuddyPool *pool, int block, int order)
+{
+    pool->blockOrder[block] = (unsigned char)order;
+    pool->blockState[block] = BLOCK_FREE;
+    pool->prevFree[block] = NO_BLOCK;
+    pool->nextFree[block] = pool->freeHeads[order];
+
+    if(pool->freeHeads[order] != NO_BLOCK)
+    {
+        pool->prevFree[pool->freeHeads[order]] = block;
+    }
+
+    pool->freeHeads[order] = block;
+    pool->freeKB += 1 << order;
+}
+
+/**
+ * @brief Unlinks a free block from the list of its order.
+ *
+ * @param[in,out] pool Pool the block is in
+ *
+ * @param[in] block Address of the block
+ *
+ * @param[in] order Order of the block
+ *
+ * @return none
+ */
+void removeFreeBlock(BuddyPool *pool, int block, int order)
+{
+    if(pool->prevFree[block] == NO_BLOCK)
+    {
+        pool->freeHeads[order] = pool->nextFree[block];
+    }
+    else
+    {
+        pool->nextFree[pool->prevFree[block]] = pool->nextFree[block];
+    }
+
+    if(pool->nextFree[block] != NO_BLOCK)
+    {
+        pool->prevFree[pool->nextFree[block]] = pool->prevFree[block];
+    }
+
+    pool->freeKB -= 1 << order;
+}
@@ -0,0 +1,50 @@
+#ifndef SIM_BUDDY_H
+#define SIM_BUDDY_H
+
+#include <stdlib.h>
+#include "StringUtils.h"
+
+// constant for an address holding no block
+extern const int NO_BLOCK;
+
+// what starts at each KB of the pool
+typedef enum {  BLOCK_NONE,
+                BLOCK_FREE,
+                BLOCK_USED } BlockStateCodes;
+
+// counts of a pool's block operations
+typedef struct
+{
+    long allocations;
+    long failures;
+    long frees;
+    long merges;
+} BuddyStats;
+
+// buddy system over a pool of KB units; a block of order n is 2^n KB
+// and starts at a multiple of its size, and each order has a free list
+// linked through the per-KB arrays; callers lock around it if shared
+typedef struct
+{
+    int totalKB;
+    int freeKB;
+    int maxOrder;
+    int *freeHeads;
+    int *nextFree;
+    int *prevFree;
+    unsigned char *blockOrder;
+    unsigned char *blockState;
+    BuddyStats stats;
+} BuddyPool;
+
+// function prototypes
+void createBuddyPool(BuddyPool *pool, int totalKB);
+void freeBuddyPool(BuddyPool *pool);
+int allocBuddyBlock(BuddyPool *pool, int sizeKB);
+void freeBuddyBlock(BuddyPool *pool, int block);
+int getBlockOrder(int sizeKB);
+int getLargestFreeKB(BuddyPool *pool);
+void addFreeBlock(BuddyPool *pool, int block, int order);
+void removeFreeBlock(BuddyPool *pool, int block, int order);
+
+#endif // SIM_BUDDY_H
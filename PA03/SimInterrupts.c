@@ -0,0 +1,147 @@
+// Header files
+#include "SimInterrupts.h"
+#include "simtimer.h"
+
+// Interrupt queue ////////////////////////////////////////////////////////////
+
+// Device service threads raise an interrupt when an I/O op finishes and
+// never log; the CPU takes all pending interrupts between ops and logs
+// them itself. Before taking them the CPU syncs with the timer, so every
+// op finishing at the current simulated time has been raised, and the
+// batch is put in completion time then issue order. Which device thread
+// happens to run first therefore never changes the log.
+
+static pthread_mutex_t interruptLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t interruptCond = PTHREAD_COND_INITIALIZER;
+static Interrupt *pendingHead = NULL;
+static Boolean cpuWaiting = False;
+
+/**
+ * @brief Raises an interrupt for a finished I/O op.
+ *
+ * @details Stamps the interrupt with the current simulated time. An
+ *          idle CPU is resumed on its behalf, so the clock does not
+ *          advance before the CPU services the interrupt.
+ *
+ * @param[in,out] interrupt Interrupt to raise, owned by the CPU side
+ *
+ * @return none
+ */
+void raiseInterrupt(Interrupt *interrupt)
+{
+    interrupt->doneUSec = getTimerUSec();
+
+    pthread_mutex_lock(&interruptLock);
+
+    interrupt->next = pendingHead;
+    pendingHead = interrupt;
+
+    if(cpuWaiting == True)
+    {
+        cpuWaiting = False;
+        resumeTimerThread();
+        pthread_cond_signal(&interruptCond);
+    }
+
+    pthread_mutex_unlock(&interruptLock);
+}
+
+/**
+ * @brief Idles the CPU until an interrupt is pending.
+ *
+ * @details The CPU is suspended for timer accounting while it waits;
+ *          the device thread raising the interrupt resumes it.
+ *
+ * @return none
+ */
+void waitForInterrupt(void)
+{
+    pthread_mutex_lock(&interruptLock);
+
+    if(pendingHead == NULL)
+    {
+        cpuWaiting = True;
+
+        pthread_mutex_unlock(&interruptLock);
+        suspendTimerThread();
+        pthread_mutex_lock(&interruptLock);
+
+        while(cpuWaiting == True)
+        {
+            pthread_cond_wait(&interruptCond, &interruptLock);
+        }
+    }
+
+    pthread_mutex_unlock(&interruptLock);
+}
+
+/**
+ * @brief Takes every pending interrupt.
+ *
+ * @details Syncs with the timer first so that no op finishing at the
+ *          current simulated time is missed.
+ *
+ * @return Taken interrupts, by completion time then issue order,
+ *         or NULL if none are pending
+ */
+Interrupt *takeInterrupts(void)
+{
+    Interrupt *takenHead = NULL;
+    Interrupt *interrupt, *nextInterrupt;
+
+    syncTimerThreads();
+
+    pthread_mutex_lock(&interruptLock);
+
+    interrupt = pendingHead;
+    pendingHead = NULL;
+
+    pthread_mutex_unlock(&interruptLock);
+
+    while(interrupt != NULL)
+    {
+        nextInterrupt = interrupt->next;
+        takenHead = addInterruptInOrder(takenHead, interrupt);
+        interrupt = nextInterrupt;
+    }
+
+    return takenHead;
+}
+
+/**
+ * @brief Inserts an interrupt into a list kept in service order.
+ *
+ * @details Batches hold at most one interrupt per blocked process,
+ *          so a simple insertion is enough.
+ *
+ * @param[in] listHead Head of the ordered list
+ *
+ * @param[in,out] interrupt Interrupt to insert
+ *
+ * @return Head of the list with the interrupt inserted
+ */
+Interrupt *addInterruptInOrder(Interrupt *listHead, Interrupt *interrupt)
+{
+    Interrupt *prevInterrupt = NULL;
+    Interrupt *currInterrupt = listHead;
+
+    while(currInterrupt != NULL
+           && (currInterrupt->doneUSec < interrupt->doneUSec
+                || (currInterrupt->doneUSec == interrupt->doneUSec
+                     && currInterrupt->sequence < interrupt->sequence)))
+    {
+        prevInterrupt = currInterrupt;
+        currInterrupt = currInterrupt->next;
+    }
+
+    interrupt->next = currInterrupt;
+
+    if(prevInterrupt == NULL)
+    {
+        return interrupt;
+    }
+
+    prevInterrupt->next = interrupt;
+
+    return listHead;
+}
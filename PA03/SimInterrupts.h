@@ -0,0 +1,24 @@
+#ifndef SIM_INTERRUPTS_H
+#define SIM_INTERRUPTS_H
+
+#include <pthread.h>
+#include "StringUtils.h"
+
+// completion of an I/O op, raised by a device service thread and
+// serviced by the CPU between ops
+typedef struct Interrupt
+{
+    int procNum;
+    int opIndex;
+    long sequence;          // order the op was issued in
+    long long doneUSec;     // simulated time the op finished
+    struct Interrupt *next;
+} Interrupt;
+
+// function prototypes
+void raiseInterrupt(Interrupt *interrupt);
+void waitForInterrupt(void);
+Interrupt *takeInterrupts(void);
+Interrupt *addInterruptInOrder(Interrupt *listHead, Interrupt *interrupt);
+
+#endif // SIM_INTERRUPTS_H
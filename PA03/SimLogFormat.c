@@ -0,0 +1,421 @@
+// Header files
+#include <string.h>         // for memset
+#include "SimLogFormat.h"
+#include "SimUtils.h"       // for ProcStateStatus
+
+// constants identifying binary log files
+const char BINARY_LOG_MAGIC[] = "SIMLOG1";
+const int BINARY_LOG_VERSION = 3;
+
+// base that packs a from and to state into a state event operand
+const int STATE_OPERAND_BASE = 256;
+
+// constants for binary log records: a record's first byte holds its
+// event code and flags for the fields it carries, the rest are left
+// out as zero; the longest record is that byte, four numbers of up
+// to ten bytes and an op kind byte
+const int LOG_PROC_FLAG = 0x20;
+const int LOG_OPERAND_FLAG = 0x40;
+const int LOG_OP_FLAG = 0x80;
+const int LOG_EVENT_MASK = 0x1f;
+const int MAX_LOG_RECORD_BYTES = 42;
+
+// names of ProcStateStatus values, in order
+static const char *procStateNames[] = { "NEW", "READY", "RUNNING",
+                                                      "BLOCKED", "EXIT" };
+
+/**
+ * @brief Formats an event as a log line.
+ *
+ * @details Times are shown as simtimer's timeToString shows them,
+ *          seconds padded to two places and six digits of usec.
+ *
+ * @param[in] logEvent Event to format
+ *
+ * @param[out] outString Formatted log line
+ *
+ * @return none
+ */
+void formatLogEvent(LogEvent *logEvent, char *outString)
+{
+    char timerString[MAX_STR_LEN];
+    char opString[MAX_STR_LEN];
+    int procNum = logEvent->procNum;
+    int operand = logEvent->operand;
+
+    sprintf(timerString, "%2d.%06d", (int)(logEvent->timeUSec / 1000000),
+                                        (int)(logEvent->timeUSec % 1000000));
+
+    switch(logEvent->eventCode)
+    {
+        case SYSTEM_START_EVENT:
+            sprintf(outString, "  %s, OS: System Start\n", timerString);
+            break;
+
+        case CREATE_PCBS_EVENT:
+            sprintf(outString, "  %s, OS: Create Process Control Blocks\n",
+                                                                  timerString);
+            break;
+
+        case PROCS_NEW_EVENT:
+            sprintf(outString,
+                        "  %s, OS: All Processes initialized in NEW state\n",
+                                                                  timerString);
+            break;
+
+        case PROCS_READY_EVENT:
+            sprintf(outString,
+                        "  %s, OS: All Processes now set in READY state\n",
+                                                                  timerString);
+            break;
+
+        case PROC_SELECTED_EVENT:
+            sprintf(outString,
+                    "  %s, OS: Process %d selected with %d ms remaining\n",
+                                               timerString, procNum, operand);
+            break;
+
+        case PROC_RUNNING_EVENT:
+            sprintf(outString, "  %s, OS: Process %d set in RUNNING state\n\n",
+                                                         timerString, procNum);
+            break;
+
+        case OP_START_EVENT:
+        case OP_END_EVENT:
+            formatOpName(logEvent->opKind, opString);
+
+            sprintf(outString, "  %s, Process: %d, %s %s\n", timerString,
+                        procNum, opString,
+                        logEvent->eventCode == OP_START_EVENT ? "start" : "end");
+            break;
+
+        case MMU_ALLOCATE_EVENT:
+            sprintf(outString,
+                      "  %s, Process: %d, MMU attempt to allocate %d/%d/%d\n",
+                      timerString, procNum, operand / 1000000,
+                      (operand / 1000) % 1000, operand % 1000);
+            break;
+
+        case MMU_ALLOCATE_FAILED_EVENT:
+            sprintf(outString, "  %s, Process: %d, MMU failed to allocate\n",
+                                                         timerString, procNum);
+            break;
+
+        case MMU_ALLOCATED_EVENT:
+            sprintf(outString, "  %s, Process: %d, MMU successful allocation\n",
+                                                         timerString, procNum);
+            break;
+
+        case MMU_ACCESS_EVENT:
+            sprintf(outString,
+                      "  %s, Process: %d, MMU attempt to access %d/%d/%d\n",
+                      timerString, procNum, operand / 1000000,
+                      (operand / 1000) % 1000, operand % 1000);
+            break;
+
+        case MMU_ACCESS_FAILED_EVENT:
+            sprintf(outString, "  %s, Process: %d, MMU failed to access\n",
+                                                         timerString, procNum);
+            break;
+
+        case SEG_FAULT_EVENT:
+            sprintf(outString,
+                        "  %s, Process: %d, experiences segmentation fault\n",
+                                                         timerString, procNum);
+            break;
+
+        case PROC_EXIT_EVENT:
+            sprintf(outString,
+                        "\n  %s, OS: Process %d ended and set in EXIT state\n",
+                                                         timerString, procNum);
+            break;
+
+        case SYSTEM_STOP_EVENT:
+            sprintf(outString, "  %s, OS: System Stop\n", timerString);
+            break;
+
+        case PROC_STATE_EVENT:
+            sprintf(outString, "  %s, OS: Process %d set from %s to %s\n%s",
+                    timerString, procNum,
+                    procStateNames[operand / STATE_OPERAND_BASE],
+                    procStateNames[operand % STATE_OPERAND_BASE],
+                    operand % STATE_OPERAND_BASE == RUNNING ? "\n" : "");
+            break;
+
+        case PROC_BLOCKED_EVENT:
+            sprintf(outString,
+                    "  %s, OS: Process %d blocked for %s operation\n",
+                    timerString, procNum,
+                    opKindToLetter(logEvent->opKind) == 'I' ? "input" : "output");
+            break;
+
+        case PROC_PREEMPTED_EVENT:
+            sprintf(outString,
+                    "  %s, OS: Process %d preempted with %d ms remaining\n",
+                                               timerString, procNum, operand);
+            break;
+
+        case PROC_QUANTUM_EVENT:
+            sprintf(outString,
+                    "  %s, OS: Process %d quantum time out, %d ms remaining\n",
+                                               timerString, procNum, operand);
+            break;
+
+        case INTERRUPT_EVENT:
+            formatOpName(logEvent->opKind, opString);
+
+            sprintf(outString,
+                    "  %s, OS: Interrupted by process %d, %s operation\n",
+                                             timerString, procNum, opString);
+            break;
+
+        case CPU_IDLE_EVENT:
+            sprintf(outString,
+                        "  %s, OS: CPU idle, all active processes blocked\n",
+                                                                  timerString);
+            break;
+
+        case CPU_IDLE_END_EVENT:
+            sprintf(outString, "  %s, OS: CPU interrupt, end idle\n",
+                                                                  timerString);
+            break;
+    }
+}
+
+/**
+ * @brief Formats an op's name as the log shows it.
+ *
+ * @details Run ops read "run operation", I/O ops name the device and
+ *          direction, such as "hard drive input".
+ *
+ * @param[in] opKind Op kind code of the op
+ *
+ * @param[out] opString Formatted op name
+ *
+ * @return none
+ */
+void formatOpName(int opKind, char *opString)
+{
+    opKindToString(opKind, opString);
+
+    switch(opKindToLetter(opKind))
+    {
+        case 'P':
+            concatenateString(opString, " operation");
+            break;
+        case 'I':
+            concatenateString(opString, " input");
+            break;
+        case 'O':
+            concatenateString(opString, " output");
+            break;
+    }
+}
+
+/**
+ * @brief Encodes an event as a binary log record.
+ *
+ * @details A record is a byte holding the event code and field flags,
+ *          then the time since the previous record, then the process
+ *          number, operand, and op index and kind, each only if not
+ *          zero. Numbers are variable length, so most records take a
+ *          few bytes. A LOG_TEXT_EVENT record carries no time and is
+ *          followed by operand bytes of text written verbatim.
+ *
+ * @param[in] logEvent Event to encode
+ *
+ * @param[in,out] lastUSec Time of the previous record, updated
+ *
+ * @param[out] bytes Encoded record, MAX_LOG_RECORD_BYTES long or more
+ *
+ * @return Length of the record in bytes
+ */
+int encodeLogRecord(LogEvent *logEvent, long long *lastUSec,
+                                                    unsigned char *bytes)
+{
+    int flags = 0, length = 1;
+
+    if(logEvent->procNum != 0)
+    {
+        flags |= LOG_PROC_FLAG;
+    }
+
+    if(logEvent->operand != 0)
+    {
+        flags |= LOG_OPERAND_FLAG;
+    }
+
+    if(logEvent->opIndex != 0 || logEvent->opKind != 0)
+    {
+        flags |= LOG_OP_FLAG;
+    }
+
+    bytes[0] = (unsigned char)(logEvent->eventCode | flags);
+
+    if(logEvent->eventCode != LOG_TEXT_EVENT)
+    {
+        length += putLogNumber(logEvent->timeUSec - *lastUSec,
+                                                            &bytes[length]);
+        *lastUSec = logEvent->timeUSec;
+    }
+
+    if(flags & LOG_PROC_FLAG)
+    {
+        length += putLogNumber(logEvent->procNum, &bytes[length]);
+    }
+
+    if(flags & LOG_OPERAND_FLAG)
+    {
+        length += putLogNumber(logEvent->operand, &bytes[length]);
+    }
+
+    if(flags & LOG_OP_FLAG)
+    {
+        length += putLogNumber(logEvent->opIndex, &bytes[length]);
+        bytes[length] = (unsigned char)logEvent->opKind;
+        length++;
+    }
+
+    return length;
+}
+
+/**
+ * @brief Reads the next binary log record back into an event.
+ *
+ * @param[in] logFile Binary log positioned at a record
+ *
+ * @param[in,out] lastUSec Time of the previous record, updated
+ *
+ * @param[out] logEvent Decoded event, ready for formatLogEvent
+ *
+ * @return LOG_RECORD_READ, or LOG_RECORD_END at the end of the file,
+ *         or LOG_RECORD_TRUNCATED if it ends inside the record
+ */
+int readLogRecord(FILE *logFile, long long *lastUSec, LogEvent *logEvent)
+{
+    long long value = 0;
+    int firstByte = getc(logFile);
+    int opKind;
+
+    if(firstByte == EOF)
+    {
+        return LOG_RECORD_END;
+    }
+
+    memset(logEvent, 0, sizeof(LogEvent));
+    logEvent->eventCode = firstByte & LOG_EVENT_MASK;
+
+    if(logEvent->eventCode != LOG_TEXT_EVENT)
+    {
+        if(getLogNumber(logFile, &value) == False)
+        {
+            return LOG_RECORD_TRUNCATED;
+        }
+
+        *lastUSec += value;
+    }
+
+    logEvent->timeUSec = *lastUSec;
+
+    if(firstByte & LOG_PROC_FLAG)
+    {
+        if(getLogNumber(logFile, &value) == False)
+        {
+            return LOG_RECORD_TRUNCATED;
+        }
+
+        logEvent->procNum = (int)value;
+    }
+
+    if(firstByte & LOG_OPERAND_FLAG)
+    {
+        if(getLogNumber(logFile, &value) == False)
+        {
+            return LOG_RECORD_TRUNCATED;
+        }
+
+        logEvent->operand = (int)value;
+    }
+
+    if(firstByte & LOG_OP_FLAG)
+    {
+        opKind = EOF;
+
+        if(getLogNumber(logFile, &value) == False
+                                    || (opKind = getc(logFile)) == EOF)
+        {
+            return LOG_RECORD_TRUNCATED;
+        }
+
+        logEvent->opIndex = (int)value;
+        logEvent->opKind = opKind;
+    }
+
+    return LOG_RECORD_READ;
+}
+
+/**
+ * @brief Writes a number in a binary log record.
+ *
+ * @details The sign is folded into the low bit, so small numbers of
+ *          either sign are short, then seven bits go in each byte,
+ *          low first, with the high bit set on all but the last.
+ *
+ * @param[in] value Number to write
+ *
+ * @param[out] bytes Where to write it, up to ten bytes
+ *
+ * @return Bytes written
+ */
+int putLogNumber(long long value, unsigned char *bytes)
+{
+    unsigned long long bits = ((unsigned long long)value << 1)
+                                        ^ (unsigned long long)(value >> 63);
+    int length = 0;
+
+    while(bits >= 0x80)
+    {
+        bytes[length] = (unsigned char)(bits | 0x80);
+        bits >>= 7;
+        length++;
+    }
+
+    bytes[length] = (unsigned char)bits;
+
+    return length + 1;
+}
+
+/**
+ * @brief Reads a number written by putLogNumber.
+ *
+ * @param[in] logFile Binary log positioned at the number
+ *
+ * @param[out] value Number read
+ *
+ * @return True, or False if the file ends inside the number or it is
+ *         longer than any number written
+ */
+Boolean getLogNumber(FILE *logFile, long long *value)
+{
+    unsigned long long bits = 0;
+    int shift = 0;
+    int nextByte;
+
+    do
+    {
+        nextByte = getc(logFile);
+
+        if(nextByte == EOF || shift > 63)
+        {
+            return False;
+        }
+
+        bits |= (unsigned long long)(nextByte & 0x7f) << shift;
+        shift += 7;
+    }
+    while(nextByte & 0x80);
+
+    *value = (long long)(bits >> 1) ^ -(long long)(bits & 1);
+
+    return True;
+}
@@ -0,0 +1,82 @@
+#ifndef SIM_LOG_FORMAT_H
+#define SIM_LOG_FORMAT_H
+
+#include <stdio.h>
+#include "StringUtils.h"
+#include "MetaDataAccess.h"
+
+// constants identifying binary log files
+extern const char BINARY_LOG_MAGIC[];
+extern const int BINARY_LOG_VERSION;
+
+// constant packing both states into a PROC_STATE_EVENT operand
+extern const int STATE_OPERAND_BASE;
+
+// constants for binary log records: flags in the high bits of a
+// record's first byte, and the longest a record can be
+extern const int LOG_PROC_FLAG;
+extern const int LOG_OPERAND_FLAG;
+extern const int LOG_OP_FLAG;
+extern const int LOG_EVENT_MASK;
+extern const int MAX_LOG_RECORD_BYTES;
+
+// event codes must stay below 32, the bits above them flag a record's
+// fields in binary logs
+typedef enum {  SYSTEM_START_EVENT,
+                CREATE_PCBS_EVENT,
+                PROCS_NEW_EVENT,
+                PROCS_READY_EVENT,
+                PROC_SELECTED_EVENT,
+                PROC_RUNNING_EVENT,
+                OP_START_EVENT,
+                OP_END_EVENT,
+                MMU_ALLOCATE_EVENT,
+                MMU_ALLOCATE_FAILED_EVENT,
+                MMU_ALLOCATED_EVENT,
+                MMU_ACCESS_EVENT,
+                MMU_ACCESS_FAILED_EVENT,
+                SEG_FAULT_EVENT,
+                PROC_EXIT_EVENT,
+                SYSTEM_STOP_EVENT,
+                LOG_TEXT_EVENT,
+                PROC_STATE_EVENT,
+                PROC_BLOCKED_EVENT,
+                PROC_PREEMPTED_EVENT,
+                PROC_QUANTUM_EVENT,
+                INTERRUPT_EVENT,
+                CPU_IDLE_EVENT,
+                CPU_IDLE_END_EVENT } LogEventCodes;
+
+// results of reading a binary log record
+typedef enum {  LOG_RECORD_READ,
+                LOG_RECORD_END,
+                LOG_RECORD_TRUNCATED } LogReadCodes;
+
+// pre-encoded log event, formatted to text by the logger thread
+typedef struct
+{
+    long long timeUSec;
+    int eventCode;
+    int procNum;
+    int opIndex;
+    int operand;
+    int opKind;
+} LogEvent;
+
+// binary log file starts with this header, followed by records
+typedef struct
+{
+    char magic[ 8 ];
+    int version;
+} BinaryLogHeader;
+
+// function prototypes
+void formatLogEvent(LogEvent *logEvent, char *outString);
+void formatOpName(int opKind, char *opString);
+int encodeLogRecord(LogEvent *logEvent, long long *lastUSec,
+                                                    unsigned char *bytes);
+int readLogRecord(FILE *logFile, long long *lastUSec, LogEvent *logEvent);
+int putLogNumber(long long value, unsigned char *bytes);
+Boolean getLogNumber(FILE *logFile, long long *value);
+
+#endif // SIM_LOG_FORMAT_H
@@ -0,0 +1,600 @@
+// Header files
+#include "SimLogger.h"
+#include "simtimer.h"
+
+// constants for streaming log writes: buffer size in bytes, and the
+// longest time (usec) a line may wait in the buffer before a flush
+const int LOG_BUFFER_SIZE = 64 * 1024;
+const long long LOG_FLUSH_USEC = 500000;
+
+// constants for the logger thread: events the ring holds, and how long
+// (usec) the logger sleeps when the ring is found empty
+const long LOG_RING_SIZE = 4096;
+const int LOGGER_IDLE_USEC = 1000;
+
+// Logger state ///////////////////////////////////////////////////////////////
+
+// During the simulation producers only stamp and enqueue a LogEvent;
+// the logger thread formats each event and does all console and file
+// writes. Before startLogger and after stopLogger, outputLine writes
+// directly, which is how the header and banners are produced.
+// In binary format the log file gets compact records instead of text,
+// see SimLogFormat.c, and the logger only formats lines that go to the
+// monitor.
+
+static int logToCode = LOGTO_MONITOR_CODE;
+static int logFormatCode = LOG_FORMAT_TEXT_CODE;
+static LogBuffer simLogBuffer;
+static LogRing logRing;
+static pthread_t loggerThread;
+static Boolean loggerRunning = False;
+static long long lastRecordUSec = 0;
+
+/**
+ * @brief Opens the simulation log.
+ *
+ * @details Opens the streaming log file when logging to FILE or BOTH,
+ *          and writes the log file header to it.
+ *
+ * @param[in] configData Pointer to config data struct
+ *
+ * @return none
+ */
+void openSimLog(ConfigDataType *configData)
+{
+    BinaryLogHeader fileHeader;
+
+    logToCode = configData->logToCode;
+    logFormatCode = configData->logFormatCode;
+
+    if(logToCode != LOGTO_MONITOR_CODE)
+    {
+        openLogBuffer(&simLogBuffer, configData->logToFileName);
+
+        if(logFormatCode == LOG_FORMAT_BINARY_CODE)
+        {
+            memset(&fileHeader, 0, sizeof(BinaryLogHeader));
+            copyString(fileHeader.magic, (char *)BINARY_LOG_MAGIC);
+            fileHeader.version = BINARY_LOG_VERSION;
+            lastRecordUSec = 0;
+
+            addLogBytes(&simLogBuffer, (char *)&fileHeader,
+                                                     sizeof(BinaryLogHeader));
+        }
+
+        createLogFileHeader(configData);
+    }
+    else
+    {
+        openLogBuffer(&simLogBuffer, NULL);
+    }
+}
+
+/**
+ * @brief Closes the simulation log.
+ *
+ * @details Stops the logger if still running, then writes out remaining
+ *          lines and closes the log file.
+ *
+ * @return none
+ */
+void closeSimLog(void)
+{
+    stopLogger();
+    closeLogBuffer(&simLogBuffer);
+}
+
+/**
+ * @brief Starts the logger thread.
+ *
+ * @details Allocates the event ring with each slot sequence set to its
+ *          own index, marking every slot free for the first lap.
+ *
+ * @return none
+ */
+void startLogger(void)
+{
+    long index;
+
+    logRing.slots = (LogSlot *)malloc(LOG_RING_SIZE * sizeof(LogSlot));
+    logRing.mask = LOG_RING_SIZE - 1;
+    logRing.enqueuePos = 0;
+    logRing.dequeuePos = 0;
+    logRing.stopRequested = False;
+
+    for(index = 0; index < LOG_RING_SIZE; index++)
+    {
+        logRing.slots[index].sequence = index;
+    }
+
+    loggerRunning = True;
+    pthread_create(&loggerThread, NULL, runLogger, NULL);
+}
+
+/**
+ * @brief Stops the logger thread.
+ *
+ * @details The logger drains every event already enqueued before
+ *          exiting, so all lines are written when this returns.
+ *
+ * @return none
+ */
+void stopLogger(void)
+{
+    if(loggerRunning == True)
+    {
+        __atomic_store_n(&logRing.stopRequested, True, __ATOMIC_RELEASE);
+        pthread_join(loggerThread, NULL);
+
+        free(logRing.slots);
+        loggerRunning = False;
+    }
+}
+
+/**
+ * @brief Records a simulation event.
+ *
+ * @details Stamps the event with the current simulation time and
+ *          enqueues it; no formatting or output is done by the caller.
+ *
+ * @param[in] eventCode Event code from LogEventCodes
+ *
+ * @param[in] procNum Process number, if any
+ *
+ * @param[in] operand Event value, such as remaining time or memory op
+ *
+ * @return none
+ */
+void logSimEvent(int eventCode, int procNum, int operand)
+{
+    LogEvent newEvent;
+
+    newEvent.timeUSec = getTimerUSec();
+    newEvent.eventCode = eventCode;
+    newEvent.procNum = procNum;
+    newEvent.operand = operand;
+    newEvent.opIndex = -1;
+    newEvent.opKind = NO_OP_KIND;
+
+    enqueueLogEvent(&newEvent);
+}
+
+/**
+ * @brief Records an event about an op, such as its start or end.
+ *
+ * @param[in] eventCode Op event code, such as OP_START_EVENT
+ *
+ * @param[in] procNum Process number
+ *
+ * @param[in] opIndex Op table index of the op
+ *
+ * @param[in] opKind Op kind code of the op
+ *
+ * @return none
+ */
+void logOpEvent(int eventCode, int procNum, int opIndex, int opKind)
+{
+    LogEvent newEvent;
+
+    newEvent.timeUSec = getTimerUSec();
+    newEvent.eventCode = eventCode;
+    newEvent.procNum = procNum;
+    newEvent.operand = 0;
+    newEvent.opIndex = opIndex;
+    newEvent.opKind = opKind;
+
+    enqueueLogEvent(&newEvent);
+}
+
+/**
+ * @brief Records a process moving from one state to another.
+ *
+ * @details Both states are packed into the event operand.
+ *
+ * @param[in] procNum Process number
+ *
+ * @param[in] fromState State the process leaves
+ *
+ * @param[in] toState State the process enters
+ *
+ * @return none
+ */
+void logStateEvent(int procNum, int fromState, int toState)
+{
+    logSimEvent(PROC_STATE_EVENT, procNum,
+                          fromState * STATE_OPERAND_BASE + toState);
+}
+
+/**
+ * @brief Adds an event to the ring.
+ *
+ * @details Producers claim a position with compare and swap, copy the
+ *          event into that slot, then publish it by advancing the slot
+ *          sequence. A full ring makes the producer yield until the
+ *          logger frees a slot.
+ *
+ * @param[in] newEvent Event to enqueue
+ *
+ * @return none
+ */
+void enqueueLogEvent(LogEvent *newEvent)
+{
+    LogSlot *slot;
+    long position, sequence, difference;
+
+    position = __atomic_load_n(&logRing.enqueuePos, __ATOMIC_RELAXED);
+
+    while(True)
+    {
+        slot = &logRing.slots[position & logRing.mask];
+        sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        difference = sequence - position;
+
+        // slot is free for this lap, try to claim it
+        if(difference == 0)
+        {
+            if(__atomic_compare_exchange_n(&logRing.enqueuePos, &position,
+                            position + 1, True, __ATOMIC_RELAXED,
+                                                         __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+
+        // ring is full, wait for the logger
+        else if(difference < 0)
+        {
+            sched_yield();
+            position = __atomic_load_n(&logRing.enqueuePos, __ATOMIC_RELAXED);
+        }
+
+        // another producer claimed it first
+        else
+        {
+            position = __atomic_load_n(&logRing.enqueuePos, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->event = *newEvent;
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Takes the oldest event from the ring.
+ *
+ * @details Only the logger thread dequeues, so no claim is needed.
+ *
+ * @param[out] nextEvent Event removed from the ring
+ *
+ * @return Boolean True if an event was available
+ */
+Boolean dequeueLogEvent(LogEvent *nextEvent)
+{
+    LogSlot *slot = &logRing.slots[logRing.dequeuePos & logRing.mask];
+    long sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+
+    if(sequence != logRing.dequeuePos + 1)
+    {
+        return False;
+    }
+
+    *nextEvent = slot->event;
+
+    // free the slot for the producers' next lap
+    __atomic_store_n(&slot->sequence, logRing.dequeuePos + LOG_RING_SIZE,
+                                                          __ATOMIC_RELEASE);
+    logRing.dequeuePos++;
+
+    return True;
+}
+
+/**
+ * @brief Logger thread.
+ *
+ * @details Formats and writes events as they arrive, sleeping briefly
+ *          whenever the ring is empty, and exits once a stop has been
+ *          requested and the ring is drained.
+ *
+ * @param[in] unused Unused thread argument
+ *
+ * @return none
+ */
+void *runLogger(void *unused)
+{
+    LogEvent nextEvent;
+    struct timespec idleTime;
+    int stopRequested;
+
+    idleTime.tv_sec = 0;
+    idleTime.tv_nsec = LOGGER_IDLE_USEC * 1000;
+
+    while(True)
+    {
+        // read stop flag first so no event published before it is missed
+        stopRequested = __atomic_load_n(&logRing.stopRequested,
+                                                          __ATOMIC_ACQUIRE);
+
+        if(dequeueLogEvent(&nextEvent) == True)
+        {
+            writeLogEvent(&nextEvent);
+        }
+        else if(stopRequested == True)
+        {
+            break;
+        }
+        else
+        {
+            nanosleep(&idleTime, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Writes one event to the monitor and log file.
+ *
+ * @details Binary format files get the encoded record, otherwise the
+ *          event is formatted once and handled as any other line.
+ *
+ * @param[in] logEvent Event to write
+ *
+ * @return none
+ */
+void writeLogEvent(LogEvent *logEvent)
+{
+    char outString[MAX_STR_LEN];
+    unsigned char recordBytes[MAX_LOG_RECORD_BYTES];
+    int recordLength;
+
+    if(logFormatCode == LOG_FORMAT_BINARY_CODE)
+    {
+        if(logToCode != LOGTO_MONITOR_CODE)
+        {
+            recordLength = encodeLogRecord(logEvent, &lastRecordUSec,
+                                                                recordBytes);
+            addLogBytes(&simLogBuffer, (char *)recordBytes, recordLength);
+        }
+
+        if(logToCode != LOGTO_FILE_CODE)
+        {
+            formatLogEvent(logEvent, outString);
+            printf("%s", outString);
+        }
+    }
+    else
+    {
+        formatLogEvent(logEvent, outString);
+        outputLine(outString);
+    }
+}
+
+/**
+ * Handles output depending on logToCode.
+ * If logToCode is MONITOR, prints string.
+ * If logToCode is FILE, saves string to buffer.
+ * If logToCode is BOTH, prints and saves string to buffer.
+ *
+ * Note: called directly only while the logger thread is not running.
+ */
+void outputLine(char *inputStr)
+{
+    if(logToCode != LOGTO_MONITOR_CODE)
+    {
+        outputFileLine(inputStr);
+    }
+
+    if(logToCode != LOGTO_FILE_CODE)
+    {
+        printf("%s", inputStr);
+    }
+}
+
+/**
+ * @brief Writes a line of text to the log file only.
+ *
+ * @details Binary log files store the line as a text record, which is
+ *          a record header holding the length followed by the text.
+ *
+ * @param[in] inputStr Line of text
+ *
+ * @return none
+ */
+void outputFileLine(char *inputStr)
+{
+    LogEvent textEvent;
+    unsigned char recordBytes[MAX_LOG_RECORD_BYTES];
+    int recordLength;
+
+    if(logFormatCode == LOG_FORMAT_BINARY_CODE)
+    {
+        memset(&textEvent, 0, sizeof(LogEvent));
+        textEvent.eventCode = LOG_TEXT_EVENT;
+        textEvent.operand = getStringLength(inputStr);
+
+        recordLength = encodeLogRecord(&textEvent, &lastRecordUSec,
+                                                                recordBytes);
+        addLogBytes(&simLogBuffer, (char *)recordBytes, recordLength);
+        addLogBytes(&simLogBuffer, inputStr, textEvent.operand);
+    }
+    else
+    {
+        addLogRecord(&simLogBuffer, inputStr);
+    }
+}
+
+
+/**
+ * @details Creates log file header when log to code is FILE or BOTH
+ *
+ * @param[in] configData Pointer to config data struct
+ *
+ * @return none
+ */
+void createLogFileHeader(ConfigDataType *configData)
+{
+    char tempStr[MAX_STR_LEN];
+
+    outputFileLine("===================================");
+    outputFileLine("Simulator Log File Header\n\n");
+
+    sprintf(tempStr, "File Name                       : %s\n",
+                                                  configData->metaDataFileName);
+
+    outputFileLine(tempStr);
+
+    char cpuSchedCode[MAX_STR_LEN];
+    configCodeToString(configData->cpuSchedCode, cpuSchedCode);
+    sprintf(tempStr, "CPU Scheduling                  : %s\n", cpuSchedCode);
+    outputFileLine(tempStr);
+
+    sprintf(tempStr, "Quantum Cycles                  : %d\n",
+                                                     configData->quantumCycles);
+    outputFileLine(tempStr);
+
+    sprintf(tempStr, "Memory Available (KB)           : %d\n",
+                                                      configData->memAvailable);
+    outputFileLine(tempStr);
+
+    sprintf(tempStr, "Processor Cycle Rate (ms/cycle) : %d\n",
+                                                     configData->procCycleRate);
+    outputFileLine(tempStr);
+
+    sprintf(tempStr, "I/O Cycle Rate (ms/cycle)       : %d\n\n",
+                                                       configData->ioCycleRate);
+    outputFileLine(tempStr);
+}
+
+/**
+ * @brief Opens the streaming log.
+ *
+ * @details Allocates the fixed size write buffer and opens the log file.
+ *          With no file name (Log To: Monitor) nothing is buffered.
+ *
+ * @param[out] logBuffer Log buffer to initialize
+ *
+ * @param[in] outputFileName The name of the output log file, or NULL
+ *
+ * @return none
+ */
+void openLogBuffer(LogBuffer *logBuffer, char *outputFileName)
+{
+    logBuffer->text = NULL;
+    logBuffer->length = 0;
+    logBuffer->logFile = NULL;
+    logBuffer->lastFlushUSec = getMonotonicUSec();
+
+    if(outputFileName != NULL)
+    {
+        logBuffer->logFile = fopen(outputFileName, "w");
+
+        if(logBuffer->logFile == NULL)
+        {
+            printf("ERROR: Unable to open log file %s\n", outputFileName);
+            return;
+        }
+
+        logBuffer->text = (char *)malloc(LOG_BUFFER_SIZE);
+    }
+}
+
+/**
+ * @brief Appends a record to the log buffer.
+ *
+ * @details Copies the string to the tail cursor. The buffer is written
+ *          through to the log file when the record would not fit, or
+ *          when the oldest buffered line has waited LOG_FLUSH_USEC, so
+ *          memory use stays fixed however long the run is.
+ *
+ * @param[in] logBuffer Log buffer to append to
+ *
+ * @param[in] logString Output string for new record
+ *
+ * @return none
+ */
+void addLogRecord(LogBuffer *logBuffer, char *logString)
+{
+    addLogBytes(logBuffer, logString, getStringLength(logString));
+}
+
+/**
+ * @brief Appends raw bytes to the log buffer.
+ *
+ * @details Used directly for binary records, flushing rules are the
+ *          same as for text records.
+ *
+ * @param[in] logBuffer Log buffer to append to
+ *
+ * @param[in] bytes Bytes to append
+ *
+ * @param[in] byteCount Number of bytes, at most LOG_BUFFER_SIZE
+ *
+ * @return none
+ */
+void addLogBytes(LogBuffer *logBuffer, char *bytes, int byteCount)
+{
+    long long nowUSec;
+
+    if(logBuffer->text == NULL)
+    {
+        return;
+    }
+
+    if(logBuffer->length + byteCount > LOG_BUFFER_SIZE)
+    {
+        flushLogBuffer(logBuffer);
+    }
+
+    memcpy(logBuffer->text + logBuffer->length, bytes, byteCount);
+    logBuffer->length += byteCount;
+
+    nowUSec = getMonotonicUSec();
+
+    if(nowUSec - logBuffer->lastFlushUSec >= LOG_FLUSH_USEC)
+    {
+        flushLogBuffer(logBuffer);
+    }
+}
+
+/**
+ * @brief Writes buffered records to the log file.
+ *
+ * @param[in] logBuffer Log buffer to flush
+ *
+ * @return none
+ */
+void flushLogBuffer(LogBuffer *logBuffer)
+{
+    if(logBuffer->length > 0)
+    {
+        fwrite(logBuffer->text, 1, logBuffer->length, logBuffer->logFile);
+        fflush(logBuffer->logFile);
+
+        logBuffer->length = 0;
+    }
+
+    logBuffer->lastFlushUSec = getMonotonicUSec();
+}
+
+/**
+ * @brief Closes the streaming log.
+ *
+ * @details Flushes remaining records, closes the file and releases
+ *          the write buffer.
+ *
+ * @param[in] logBuffer Log buffer to close
+ *
+ * @return none
+ */
+void closeLogBuffer(LogBuffer *logBuffer)
+{
+    if(logBuffer->text != NULL)
+    {
+        flushLogBuffer(logBuffer);
+        fclose(logBuffer->logFile);
+        free(logBuffer->text);
+    }
+
+    logBuffer->text = NULL;
+    logBuffer->logFile = NULL;
+}
@@ -0,0 +1,66 @@
+#ifndef SIM_LOGGER_H
+#define SIM_LOGGER_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include "StringUtils.h"
+#include "ConfigAccess.h"
+#include "MetaDataAccess.h"
+#include "SimLogFormat.h"
+
+// constants for streaming log writes
+extern const int LOG_BUFFER_SIZE;
+extern const long long LOG_FLUSH_USEC;
+
+// constants for the logger event ring, size must be a power of two
+extern const long LOG_RING_SIZE;
+extern const int LOGGER_IDLE_USEC;
+
+typedef struct
+{
+    long sequence;
+    LogEvent event;
+} LogSlot;
+
+// bounded lock-free ring, many producers and the logger as sole consumer
+typedef struct
+{
+    LogSlot *slots;
+    long mask;
+    long enqueuePos;
+    long dequeuePos;
+    int stopRequested;
+} LogRing;
+
+typedef struct
+{
+    char *text;
+    int length;
+    FILE *logFile;
+    long long lastFlushUSec;
+} LogBuffer;
+
+// function prototypes
+void openSimLog(ConfigDataType *configData);
+void closeSimLog(void);
+void startLogger(void);
+void stopLogger(void);
+void logSimEvent(int eventCode, int procNum, int operand);
+void logOpEvent(int eventCode, int procNum, int opIndex, int opKind);
+void logStateEvent(int procNum, int fromState, int toState);
+void enqueueLogEvent(LogEvent *newEvent);
+Boolean dequeueLogEvent(LogEvent *nextEvent);
+void *runLogger(void *unused);
+void writeLogEvent(LogEvent *logEvent);
+void outputLine(char *inputStr);
+void outputFileLine(char *inputStr);
+void createLogFileHeader(ConfigDataType *configData);
+void openLogBuffer(LogBuffer *logBuffer, char *outputFileName);
+void addLogRecord(LogBuffer *logBuffer, char *logString);
+void addLogBytes(LogBuffer *logBuffer, char *bytes, int byteCount);
+void flushLogBuffer(LogBuffer *logBuffer);
+void closeLogBuffer(LogBuffer *logBuffer);
+
+#endif // SIM_LOGGER_H
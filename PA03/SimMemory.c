@@ -0,0 +1,476 @@
+// Header files
+#include "SimMemory.h"
+
+// MMU records carved from each slab; at about 64 bytes a record, 64 KB
+const int MEM_UNITS_PER_SLAB = 1024;
+
+// MMU record slabs ///////////////////////////////////////////////////////////
+
+// MMU records are carved from slabs of MEM_UNITS_PER_SLAB rather than
+// allocated one at a time. A process's records go back on the pool's
+// free list when it exits, and slabs are only freed at the end of the
+// run. Only the dispatcher runs M ops, so the pool is not locked.
+
+static MemUnitPool memUnitPool;
+
+/**
+ * @brief Sets up an empty pool of MMU records.
+ *
+ * @return none
+ */
+void startMemUnits(void)
+{
+    memUnitPool.slabs = NULL;
+    memUnitPool.freeUnits = NULL;
+    memUnitPool.numSlabs = 0;
+}
+
+/**
+ * @brief Frees every slab of MMU records at once.
+ *
+ * @details Records still in an index are freed with their slab.
+ *
+ * @return none
+ */
+void stopMemUnits(void)
+{
+    MemUnitSlab *slab = memUnitPool.slabs;
+    MemUnitSlab *nextSlab;
+
+    while(slab != NULL)
+    {
+        nextSlab = slab->next;
+        free(slab);
+        slab = nextSlab;
+    }
+
+    startMemUnits();
+}
+
+/**
+ * @brief Takes a record from the pool, adding a slab when none is free.
+ *
+ * @return Unused record
+ */
+MemMgmtUnit *takeMemUnit(void)
+{
+    MemMgmtUnit *memUnit;
+
+    if(memUnitPool.freeUnits == NULL)
+    {
+        addMemUnitSlab();
+    }
+
+    memUnit = memUnitPool.freeUnits;
+    memUnitPool.freeUnits = memUnit->next;
+
+    return memUnit;
+}
+
+/**
+ * @brief Allocates a slab and puts its records on the free list.
+ *
+ * @return none
+ */
+void addMemUnitSlab(void)
+{
+    MemUnitSlab *slab = (MemUnitSlab *)malloc(sizeof(MemUnitSlab)
+                                + MEM_UNITS_PER_SLAB * sizeof(MemMgmtUnit));
+    int index;
+
+    for(index = 0; index < MEM_UNITS_PER_SLAB - 1; index++)
+    {
+        slab->units[index].next = &slab->units[index + 1];
+    }
+
+    slab->units[MEM_UNITS_PER_SLAB - 1].next = memUnitPool.freeUnits;
+    memUnitPool.freeUnits = &slab->units[0];
+
+    slab->next = memUnitPool.slabs;
+    memUnitPool.slabs = slab;
+    memUnitPool.numSlabs++;
+}
+
+// MMU record index ///////////////////////////////////////////////////////////
+
+// Every allocated segment is one MemMgmtUnit record, linked into two
+// AVL trees at once: one ordered by (procNum, segment id) and one by
+// base. An allocation checks both for a clash and an access looks its
+// segment up by id, so each costs O(log n) however many segments are
+// held. Records are also kept on a plain list so that clearing them
+// is a single loop with no recursion, handing the list to the pool.
+
+/**
+ * @brief Sets up an empty record index.
+ *
+ * @param[out] memIndex Record index to set up
+ *
+ * @return none
+ */
+void initMemIndex(MemIndex *memIndex)
+{
+    memIndex->root[ID_TREE] = NULL;
+    memIndex->root[BASE_TREE] = NULL;
+    memIndex->memOpHead = NULL;
+    memIndex->numSegments = 0;
+}
+
+/**
+ * @brief Records an allocated segment.
+ *
+ * @details Caller has checked with isMemSpaceFree that neither key
+ *          is in use.
+ *
+ * @param[in,out] memIndex Record index to add to
+ *
+ * @param[in] memId Segment id
+ *
+ * @param[in] memBase Segment base
+ *
+ * @param[in] memOffset Largest offset that may be accessed
+ *
+ * @param[in] procNum Process owning the segment
+ *
+ * @param[in] block Physical block holding the segment, or NO_BLOCK
+ *
+ * @return none
+ */
+void addMemOpNode(MemIndex *memIndex, int memId, int memBase,
+                                   int memOffset, int procNum, int block)
+{
+    MemMgmtUnit *newNode = takeMemUnit();
+    int tree;
+
+    newNode->procNum = procNum;
+    newNode->id = memId;
+    newNode->base = memBase;
+    newNode->offset = memOffset;
+    newNode->block = block;
+
+    for(tree = 0; tree < NUM_MEM_TREES; tree++)
+    {
+        newNode->left[tree] = NULL;
+        newNode->right[tree] = NULL;
+        newNode->height[tree] = 1;
+
+        memIndex->root[tree] = insertMemNode(memIndex->root[tree],
+                                                              newNode, tree);
+    }
+
+    newNode->next = memIndex->memOpHead;
+    memIndex->memOpHead = newNode;
+    memIndex->numSegments++;
+}
+
+/**
+ * @brief Tells whether a segment may be allocated.
+ *
+ * @param[in] memIndex Record index to check
+ *
+ * @param[in] procNumCheck Process asking for the segment
+ *
+ * @param[in] baseCheck Segment base
+ *
+ * @param[in] idCheck Segment id
+ *
+ * @return False if the base is taken, or the process already has a
+ *         segment with this id; True otherwise
+ */
+Boolean isMemSpaceFree(MemIndex *memIndex, int procNumCheck,
+                                                  int baseCheck, int idCheck)
+{
+    MemMgmtUnit keyNode;
+
+    keyNode.procNum = procNumCheck;
+    keyNode.id = idCheck;
+    keyNode.base = baseCheck;
+
+    if(findMemNode(memIndex->root[BASE_TREE], &keyNode, BASE_TREE) != NULL
+         || findMemNode(memIndex->root[ID_TREE], &keyNode, ID_TREE) != NULL)
+    {
+        return False;
+    }
+
+    return True;
+}
+
+/**
+ * @brief Checks an access against the process's segments.
+ *
+ * @param[in] memIndex Record index to check
+ *
+ * @param[in] procNum Process making the access
+ *
+ * @param[in] memId Segment id
+ *
+ * @param[in] memBase Segment base, which must match the allocation
+ *
+ * @param[in] memOffset Offset accessed
+ *
+ * @return True if the segment is allocated and the offset is in bounds
+ */
+Boolean requestMemAccess(MemIndex *memIndex, int procNum, int memId,
+                                                  int memBase, int memOffset)
+{
+    MemMgmtUnit keyNode;
+    MemMgmtUnit *segment;
+
+    keyNode.procNum = procNum;
+    keyNode.id = memId;
+
+    segment = findMemNode(memIndex->root[ID_TREE], &keyNode, ID_TREE);
+
+    if(segment == NULL || segment->base != memBase
+                                            || memOffset > segment->offset)
+    {
+        return False;
+    }
+
+    return True;
+}
+
+/**
+ * @brief Returns every record to the pool and empties the index.
+ *
+ * @details Segments are given back to physical memory.
+ *
+ * @param[in,out] memIndex Record index to clear
+ *
+ * @return none
+ */
+void clearMemoryList(MemIndex *memIndex)
+{
+    MemMgmtUnit *memOp = memIndex->memOpHead;
+    MemMgmtUnit *lastMemOp = NULL;
+
+    while(memOp != NULL)
+    {
+        if(memOp->block != NO_BLOCK)
+        {
+            freePhysMemory(memOp->block, memOp->offset + 1);
+        }
+
+        lastMemOp = memOp;
+        memOp = memOp->next;
+    }
+
+    // the record list goes back on the pool's free list whole
+    if(lastMemOp != NULL)
+    {
+        lastMemOp->next = memUnitPool.freeUnits;
+        memUnitPool.freeUnits = memIndex->memOpHead;
+    }
+
+    initMemIndex(memIndex);
+}
+
+/**
+ * @brief Finds the record with the same key in one tree.
+ *
+ * @param[in] root Root of the tree
+ *
+ * @param[in] keyNode Node holding the key fields for the tree
+ *
+ * @param[in] tree Tree code from MemTreeCodes
+ *
+ * @return Matching record, or NULL if there is none
+ */
+MemMgmtUnit *findMemNode(MemMgmtUnit *root, MemMgmtUnit *keyNode, int tree)
+{
+    int compareResult;
+
+    while(root != NULL)
+    {
+        compareResult = compareMemKeys(keyNode, root, tree);
+
+        if(compareResult == 0)
+        {
+            return root;
+        }
+
+        root = compareResult < 0 ? root->left[tree] : root->right[tree];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Inserts a record into one tree.
+ *
+ * @details Recursion only goes as deep as the balanced tree.
+ *
+ * @param[in] root Root of the tree, or NULL
+ *
+ * @param[in,out] newNode Record to insert
+ *
+ * @param[in] tree Tree code from MemTreeCodes
+ *
+ * @return New root of the tree
+ */
+MemMgmtUnit *insertMemNode(MemMgmtUnit *root, MemMgmtUnit *newNode, int tree)
+{
+    if(root == NULL)
+    {
+        return newNode;
+    }
+
+    if(compareMemKeys(newNode, root, tree) < 0)
+    {
+        root->left[tree] = insertMemNode(root->left[tree], newNode, tree);
+    }
+    else
+    {
+        root->right[tree] = insertMemNode(root->right[tree], newNode, tree);
+    }
+
+    return rebalanceMemNode(root, tree);
+}
+
+/**
+ * @brief Restores AVL balance at a node after an insert below it.
+ *
+ * @param[in,out] node Node to rebalance
+ *
+ * @param[in] tree Tree code from MemTreeCodes
+ *
+ * @return Node now at this position of the tree
+ */
+MemMgmtUnit *rebalanceMemNode(MemMgmtUnit *node, int tree)
+{
+    int balance;
+
+    updateMemHeight(node, tree);
+
+    balance = getMemHeight(node->left[tree], tree)
+                                   - getMemHeight(node->right[tree], tree);
+
+    if(balance > 1)
+    {
+        if(getMemHeight(node->left[tree]->left[tree], tree)
+                < getMemHeight(node->left[tree]->right[tree], tree))
+        {
+            node->left[tree] = rotateMemNode(node->left[tree], True, tree);
+        }
+
+        return rotateMemNode(node, False, tree);
+    }
+
+    if(balance < -1)
+    {
+        if(getMemHeight(node->right[tree]->right[tree], tree)
+                < getMemHeight(node->right[tree]->left[tree], tree))
+        {
+            node->right[tree] = rotateMemNode(node->right[tree], False, tree);
+        }
+
+        return rotateMemNode(node, True, tree);
+    }
+
+    return node;
+}
+
+/**
+ * @brief Rotates a subtree left or right.
+ *
+ * @param[in,out] node Root of the subtree
+ *
+ * @param[in] toLeft True to rotate left, False to rotate right
+ *
+ * @param[in] tree Tree code from MemTreeCodes
+ *
+ * @return New root of the subtree
+ */
+MemMgmtUnit *rotateMemNode(MemMgmtUnit *node, Boolean toLeft, int tree)
+{
+    MemMgmtUnit *newRoot;
+
+    if(toLeft == True)
+    {
+        newRoot = node->right[tree];
+        node->right[tree] = newRoot->left[tree];
+        newRoot->left[tree] = node;
+    }
+    else
+    {
+        newRoot = node->left[tree];
+        node->left[tree] = newRoot->right[tree];
+        newRoot->right[tree] = node;
+    }
+
+    updateMemHeight(node, tree);
+    updateMemHeight(newRoot, tree);
+
+    return newRoot;
+}
+
+/**
+ * @brief Orders two records by the key of one tree.
+ *
+ * @param[in] oneNode Record to compare
+ *
+ * @param[in] otherNode Record to compare against
+ *
+ * @param[in] tree Tree code from MemTreeCodes
+ *
+ * @return Negative, zero or positive as oneNode sorts before, with
+ *         or after otherNode
+ */
+int compareMemKeys(MemMgmtUnit *oneNode, MemMgmtUnit *otherNode, int tree)
+{
+    int oneKey, otherKey;
+
+    if(tree == BASE_TREE)
+    {
+        oneKey = oneNode->base;
+        otherKey = otherNode->base;
+    }
+    else if(oneNode->procNum != otherNode->procNum)
+    {
+        oneKey = oneNode->procNum;
+        otherKey = otherNode->procNum;
+    }
+    else
+    {
+        oneKey = oneNode->id;
+        otherKey = otherNode->id;
+    }
+
+    if(oneKey == otherKey)
+    {
+        return 0;
+    }
+
+    return oneKey < otherKey ? -1 : 1;
+}
+
+/**
+ * @brief Gives the height of a subtree.
+ *
+ * @param[in] node Root of the subtree, or NULL
+ *
+ * @param[in] tree Tree code from MemTreeCodes
+ *
+ * @return Height, zero for an empty subtree
+ */
+int getMemHeight(MemMgmtUnit *node, int tree)
+{
+    return node == NULL ? 0 : node->height[tree];
+}
+
+/**
+ * @brief Recomputes a node's height from its children.
+ *
+ * @param[in,out] node Node to update
+ *
+ * @param[in] tree Tree code from MemTreeCodes
+ *
+ * @return none
+ */
+void updateMemHeight(MemMgmtUnit *node, int tree)
+{
+    int leftHeight = getMemHeight(node->left[tree], tree);
+    int rightHeight = getMemHeight(node->right[tree], tree);
+
+    node->height[tree] = 1 + (leftHeight > rightHeight ? leftHeight
+                                                       : rightHeight);
+}
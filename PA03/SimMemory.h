@@ -0,0 +1,77 @@
+#ifndef SIM_MEMORY_H
+#define SIM_MEMORY_H
+
+#include <stdlib.h>
+#include "StringUtils.h"
+#include "SimPhysMem.h"
+
+// constant for the number of MMU records carved from each slab
+extern const int MEM_UNITS_PER_SLAB;
+
+// trees each MMU record is indexed in
+typedef enum {  ID_TREE,
+                BASE_TREE,
+                NUM_MEM_TREES } MemTreeCodes;
+
+// one allocated segment; it sits in an AVL tree ordered by
+// (procNum, id) and in another ordered by base, and in a plain
+// list used only to free every record
+typedef struct MemMgmtUnit
+{
+    int procNum;
+    int id;
+    int base;
+    int offset;
+    int block;          // physical block holding the segment, or NO_BLOCK
+    struct MemMgmtUnit *left[ NUM_MEM_TREES ];
+    struct MemMgmtUnit *right[ NUM_MEM_TREES ];
+    int height[ NUM_MEM_TREES ];
+    struct MemMgmtUnit *next;
+} MemMgmtUnit;
+
+// block of MMU records allocated at once
+typedef struct MemUnitSlab
+{
+    struct MemUnitSlab *next;
+    MemMgmtUnit units[];
+} MemUnitSlab;
+
+// slabs of MMU records and the records free for reuse, linked
+// through their next fields
+typedef struct
+{
+    MemUnitSlab *slabs;
+    MemMgmtUnit *freeUnits;
+    long numSlabs;
+} MemUnitPool;
+
+// MMU records of a process
+typedef struct
+{
+    MemMgmtUnit *root[ NUM_MEM_TREES ];
+    MemMgmtUnit *memOpHead;
+    int numSegments;
+} MemIndex;
+
+// function prototypes
+void startMemUnits(void);
+void stopMemUnits(void);
+MemMgmtUnit *takeMemUnit(void);
+void addMemUnitSlab(void);
+void initMemIndex(MemIndex *memIndex);
+void addMemOpNode(MemIndex *memIndex, int memId, int memBase,
+                                   int memOffset, int procNum, int block);
+Boolean isMemSpaceFree(MemIndex *memIndex, int procNumCheck,
+                                                  int baseCheck, int idCheck);
+Boolean requestMemAccess(MemIndex *memIndex, int procNum, int memId,
+                                                  int memBase, int memOffset);
+void clearMemoryList(MemIndex *memIndex);
+MemMgmtUnit *findMemNode(MemMgmtUnit *root, MemMgmtUnit *keyNode, int tree);
+MemMgmtUnit *insertMemNode(MemMgmtUnit *root, MemMgmtUnit *newNode, int tree);
+MemMgmtUnit *rebalanceMemNode(MemMgmtUnit *node, int tree);
+MemMgmtUnit *rotateMemNode(MemMgmtUnit *node, Boolean toLeft, int tree);
+int compareMemKeys(MemMgmtUnit *oneNode, MemMgmtUnit *otherNode, int tree);
+int getMemHeight(MemMgmtUnit *node, int tree);
+void updateMemHeight(MemMgmtUnit *node, int tree);
+
+#endif // SIM_MEMORY_H
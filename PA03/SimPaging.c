@@ -0,0 +1,670 @@
+// Header files
+#include "SimPaging.h"
+
+// page table entry of a page not in a frame, and frame holding no page;
+// NO_FRAME also ends the frame lists
+const int NO_FRAME = -1;
+const int NO_PAGE = -1;
+
+// largest virtual address an access can form, segment base plus offset
+const int MAX_VIRTUAL_KB = 1998;
+
+// simulated cost of a TLB lookup and of one memory read; a page walk
+// reads the page table entry from memory before the access itself
+const double TLB_LOOKUP_NSEC = 1.0;
+const double MEM_ACCESS_NSEC = 100.0;
+
+// an aging counter is eight bits, and a page starts as if referenced
+// in the last interval so it is not the next victim straight away
+const int NUM_AGES = 256;
+const int NEW_PAGE_AGE = 128;
+
+// Paged memory model ////////////////////////////////////////////////////////
+
+// In paged mode an access that passes the segment checks is also
+// translated: its address, segment base plus offset in KB, falls in a
+// virtual page that the TLB or else the process's page table maps to
+// a frame. Frames are page sized blocks of the physical memory all
+// processes share; once it is exhausted a page fault evicts one of the
+// faulting process's own pages under the configured policy. Each fault
+// charges Page Fault Time (msec) of I/O. Only the dispatcher runs M
+// ops, so the TLB and page tables are not locked.
+
+static Boolean pagingOn = False;
+static int pageSizeKB = 1;
+static int pagePolicy = PAGE_POLICY_FIFO_CODE;
+static int pageFaultMSec = 0;
+static Tlb tlb;
+static PagingStats *procStats = NULL;
+static int numStatProcs = 0;
+
+/**
+ * @brief Sets up the TLB and counts for a run in paged mode.
+ *
+ * @details Does nothing unless the config selects paged memory.
+ *
+ * @param[in] configData Pointer to config data struct
+ *
+ * @param[in] numProcesses Number of processes in the run
+ *
+ * @return none
+ */
+void startPaging(ConfigDataType *configData, int numProcesses)
+{
+    int index;
+
+    pagingOn = configData->memModeCode == MEM_MODE_PAGED_CODE;
+
+    if(pagingOn == False)
+    {
+        return;
+    }
+
+    pageSizeKB = configData->pageSizeKB;
+    pagePolicy = configData->pagePolicyCode;
+    pageFaultMSec = configData->pageFaultTime;
+
+    tlb.numWays = configData->tlbWays;
+    tlb.numSets = configData->tlbEntries / configData->tlbWays;
+    tlb.useCount = 0;
+    tlb.entries = (TlbEntry *)malloc(configData->tlbEntries
+                                                        * sizeof(TlbEntry));
+
+    for(index = 0; index < configData->tlbEntries; index++)
+    {
+        tlb.entries[index].procNum = -1;
+        tlb.entries[index].page = NO_PAGE;
+        tlb.entries[index].frame = NO_FRAME;
+        tlb.entries[index].lastUse = 0;
+    }
+
+    numStatProcs = numProcesses;
+    procStats = (PagingStats *)calloc(numProcesses > 0 ? numProcesses : 1,
+                                                        sizeof(PagingStats));
+}
+
+/**
+ * @brief Frees the TLB and counts.
+ *
+ * @return none
+ */
+void stopPaging(void)
+{
+    if(pagingOn == False)
+    {
+        return;
+    }
+
+    free(tlb.entries);
+    free(procStats);
+    procStats = NULL;
+    numStatProcs = 0;
+    pagingOn = False;
+}
+
+/**
+ * @brief Tells whether accesses are translated through pages.
+ *
+ * @return True in paged mode
+ */
+Boolean isPagingOn(void)
+{
+    return pagingOn;
+}
+
+/**
+ * @brief Gives the paging counts of every process, by process number.
+ *
+ * @param[out] numProcesses Number of processes counted
+ *
+ * @return Counts array, NULL when paging is off
+ */
+PagingStats *getPagingStats(int *numProcesses)
+{
+    *numProcesses = numStatProcs;
+
+    return procStats;
+}
+
+/**
+ * @brief Sets up an empty page table.
+ *
+ * @details Tables are allocated on the first access, so processes
+ *          that never access memory cost nothing. A process never
+ *          needs more frames than it has virtual pages.
+ *
+ * @param[out] pageTable Page table to set up
+ *
+ * @return none
+ */
+void initPageTable(PageTable *pageTable)
+{
+    pageTable->frames = NULL;
+    pageTable->numPages = MAX_VIRTUAL_KB / pageSizeKB + 1;
+    pageTable->frameTable = NULL;
+    pageTable->frameLists = NULL;
+    pageTable->numFrames = pageTable->numPages;
+    pageTable->framesUsed = 0;
+    pageTable->hand = 0;
+    pageTable->accessesToTick = 0;
+}
+
+/**
+ * @brief Frees a process's page table and frames, and drops its TLB
+ *        entries.
+ *
+ * @param[in,out] pageTable Page table to clear
+ *
+ * @param[in] procNum Process owning the table
+ *
+ * @return none
+ */
+void clearPageTable(PageTable *pageTable, int procNum)
+{
+    int index;
+
+    if(pageTable->frames == NULL)
+    {
+        return;
+    }
+
+    for(index = 0; index < pageTable->framesUsed; index++)
+    {
+        freePhysMemory(pageTable->frameTable[index].block, pageSizeKB);
+    }
+
+    for(index = 0; index < tlb.numSets * tlb.numWays; index++)
+    {
+        if(tlb.entries[index].procNum == procNum)
+        {
+            tlb.entries[index].procNum = -1;
+        }
+    }
+
+    free(pageTable->frames);
+    free(pageTable->frameTable);
+    free(pageTable->frameLists);
+    pageTable->frames = NULL;
+    pageTable->frameTable = NULL;
+    pageTable->frameLists = NULL;
+    pageTable->framesUsed = 0;
+    pageTable->hand = 0;
+}
+
+/**
+ * @brief Translates one access and counts its cost.
+ *
+ * @details Looks the page up in the TLB, walking the page table on a
+ *          miss, then marks its frame used for the replacement policy.
+ *
+ * @param[in,out] pageTable Page table of the process
+ *
+ * @param[in] procNum Process making the access
+ *
+ * @param[in] virtualKB Address accessed, in KB
+ *
+ * @param[out] faultMSec I/O time the access is charged for a page
+ *             fault, 0 when the page was in memory
+ *
+ * @return False when memory is exhausted and the process holds no
+ *         frame to evict
+ */
+Boolean accessPage(PageTable *pageTable, int procNum, int virtualKB,
+                                                            int *faultMSec)
+{
+    PagingStats *stats = &procStats[procNum];
+    int page = virtualKB / pageSizeKB;
+    TlbEntry *tlbEntry;
+    int frame;
+
+    *faultMSec = 0;
+    stats->accesses++;
+    stats->latencyNSec += TLB_LOOKUP_NSEC;
+
+    tlbEntry = findTlbEntry(procNum, page);
+
+    if(tlbEntry != NULL)
+    {
+        stats->tlbHits++;
+        frame = tlbEntry->frame;
+    }
+    else
+    {
+        frame = walkPageTable(pageTable, procNum, page, stats, faultMSec);
+
+        if(frame == NO_FRAME)
+        {
+            return False;
+        }
+
+        addTlbEntry(procNum, page, frame);
+    }
+
+    stats->latencyNSec += MEM_ACCESS_NSEC;
+    touchFrame(pageTable, frame);
+
+    // age every frame once per frame's worth of accesses, so the
+    // cost of a pass is spread over the accesses between passes
+    if(pagePolicy == PAGE_POLICY_AGING_CODE)
+    {
+        pageTable->accessesToTick--;
+
+        if(pageTable->accessesToTick <= 0)
+        {
+            ageFrames(pageTable);
+            pageTable->accessesToTick = pageTable->framesUsed;
+        }
+    }
+
+    return True;
+}
+
+/**
+ * @brief Reads a page's entry from the page table after a TLB miss.
+ *
+ * @details A page not in memory faults: it gets a new frame from
+ *          physical memory, or a victim's frame once that is exhausted.
+ *
+ * @param[in,out] pageTable Page table of the process
+ *
+ * @param[in] procNum Process making the access
+ *
+ * @param[in] page Virtual page to look up
+ *
+ * @param[in,out] stats Counts of the process
+ *
+ * @param[out] faultMSec I/O time charged when the page faults
+ *
+ * @return Frame of the page, or NO_FRAME when none can be had
+ */
+int walkPageTable(PageTable *pageTable, int procNum, int page,
+                                        PagingStats *stats, int *faultMSec)
+{
+    int frame, block;
+    int victimPage;
+
+    if(pageTable->frames == NULL)
+    {
+        allocFrameTable(pageTable);
+    }
+
+    stats->pageWalks++;
+    stats->latencyNSec += MEM_ACCESS_NSEC;
+
+    frame = pageTable->frames[page];
+
+    if(frame != NO_FRAME)
+    {
+        return frame;
+    }
+
+    block = NO_BLOCK;
+
+    // once memory is used up a process with frames evicts one without
+    // asking the pool, so evictions are not counted as failed allocations
+    if(pageTable->framesUsed == 0 || getFreePhysMemoryKB() >= pageSizeKB)
+    {
+        block = allocPhysMemory(pageSizeKB);
+    }
+
+    if(block != NO_BLOCK)
+    {
+        frame = pageTable->framesUsed;
+        pageTable->frameTable[frame].block = block;
+        pageTable->framesUsed++;
+    }
+    else if(pageTable->framesUsed == 0)
+    {
+        return NO_FRAME;
+    }
+    else
+    {
+        frame = findVictimFrame(pageTable);
+        victimPage = pageTable->frameTable[frame].page;
+
+        pageTable->frames[victimPage] = NO_FRAME;
+        dropTlbEntry(procNum, victimPage);
+        stats->evictions++;
+    }
+
+    stats->pageFaults++;
+    stats->faultMSec += pageFaultMSec;
+    *faultMSec = pageFaultMSec;
+
+    loadFrame(pageTable, frame, page);
+    pageTable->frames[page] = frame;
+
+    return frame;
+}
+
+/**
+ * @brief Allocates a process's page table and frame table.
+ *
+ * @details Aging keeps one frame list per age value, LRU a single
+ *          recency list.
+ *
+ * @param[in,out] pageTable Page table to allocate
+ *
+ * @return none
+ */
+void allocFrameTable(PageTable *pageTable)
+{
+    int numLists = pagePolicy == PAGE_POLICY_AGING_CODE ? NUM_AGES : 1;
+    int index;
+
+    pageTable->frames = (int *)malloc(pageTable->numPages * sizeof(int));
+
+    for(index = 0; index < pageTable->numPages; index++)
+    {
+        pageTable->frames[index] = NO_FRAME;
+    }
+
+    pageTable->frameTable = (PageFrame *)malloc(
+            (pageTable->numFrames > 0 ? pageTable->numFrames : 1)
+                                                        * sizeof(PageFrame));
+    pageTable->frameLists = (FrameList *)malloc(numLists
+                                                        * sizeof(FrameList));
+
+    for(index = 0; index < numLists; index++)
+    {
+        pageTable->frameLists[index].head = NO_FRAME;
+        pageTable->frameLists[index].tail = NO_FRAME;
+    }
+
+    pageTable->framesUsed = 0;
+    pageTable->hand = 0;
+    pageTable->accessesToTick = 1;
+}
+
+/**
+ * @brief Picks the frame to evict under the configured policy.
+ *
+ * @details FIFO takes the frame under the hand, which circles the
+ *          frames in the order they were first filled. CLOCK does the same
+ *          but spares, once, a frame referenced since the hand last
+ *          passed. LRU takes the head of the recency list. Aging takes
+ *          the first frame of the lowest non-empty age list, a scan
+ *          bounded by the number of ages. LRU and aging victims are
+ *          taken off their list.
+ *
+ * @param[in,out] pageTable Page table of the process, holding a frame
+ *
+ * @return Frame to evict
+ */
+int findVictimFrame(PageTable *pageTable)
+{
+    PageFrame *frameTable = pageTable->frameTable;
+    int frame = NO_FRAME;
+    int age;
+
+    switch(pagePolicy)
+    {
+        case PAGE_POLICY_LRU_CODE:
+            frame = pageTable->frameLists[0].head;
+            removeFrameFromList(pageTable, 0, frame);
+            break;
+
+        case PAGE_POLICY_AGING_CODE:
+            for(age = 0; frame == NO_FRAME; age++)
+            {
+                frame = pageTable->frameLists[age].head;
+            }
+            removeFrameFromList(pageTable, age - 1, frame);
+            break;
+
+        case PAGE_POLICY_CLOCK_CODE:
+            while(frameTable[pageTable->hand].referenced != 0)
+            {
+                frameTable[pageTable->hand].referenced = 0;
+                pageTable->hand = (pageTable->hand + 1)
+                                                    % pageTable->framesUsed;
+            }
+            frame = pageTable->hand;
+            pageTable->hand = (pageTable->hand + 1) % pageTable->framesUsed;
+            break;
+
+        default:
+            frame = pageTable->hand;
+            pageTable->hand = (pageTable->hand + 1) % pageTable->framesUsed;
+            break;
+    }
+
+    return frame;
+}
+
+/**
+ * @brief Puts a page in a frame.
+ *
+ * @param[in,out] pageTable Page table of the process
+ *
+ * @param[in] frame Frame, unused or off its list
+ *
+ * @param[in] page Virtual page loaded
+ *
+ * @return none
+ */
+void loadFrame(PageTable *pageTable, int frame, int page)
+{
+    PageFrame *pageFrame = &pageTable->frameTable[frame];
+
+    pageFrame->page = page;
+    pageFrame->referenced = 0;
+    pageFrame->age = NEW_PAGE_AGE;
+
+    if(pagePolicy == PAGE_POLICY_LRU_CODE)
+    {
+        addFrameToList(pageTable, 0, frame);
+    }
+    else if(pagePolicy == PAGE_POLICY_AGING_CODE)
+    {
+        addFrameToList(pageTable, pageFrame->age, frame);
+    }
+}
+
+/**
+ * @brief Marks a frame referenced, and most recently used under LRU.
+ *
+ * @param[in,out] pageTable Page table of the process
+ *
+ * @param[in] frame Frame accessed
+ *
+ * @return none
+ */
+void touchFrame(PageTable *pageTable, int frame)
+{
+    pageTable->frameTable[frame].referenced = 1;
+
+    if(pagePolicy == PAGE_POLICY_LRU_CODE
+                                && pageTable->frameLists[0].tail != frame)
+    {
+        removeFrameFromList(pageTable, 0, frame);
+        addFrameToList(pageTable, 0, frame);
+    }
+}
+
+/**
+ * @brief Shifts each frame's reference bit into its age.
+ *
+ * @details Each frame moves to the list of its new age and its
+ *          reference bit is cleared.
+ *
+ * @param[in,out] pageTable Page table of the process
+ *
+ * @return none
+ */
+void ageFrames(PageTable *pageTable)
+{
+    PageFrame *pageFrame;
+    int frame;
+
+    for(frame = 0; frame < pageTable->framesUsed; frame++)
+    {
+        pageFrame = &pageTable->frameTable[frame];
+
+        removeFrameFromList(pageTable, pageFrame->age, frame);
+
+        pageFrame->age = (unsigned char)((pageFrame->age >> 1)
+                                    | (pageFrame->referenced != 0 ? 128 : 0));
+        pageFrame->referenced = 0;
+
+        addFrameToList(pageTable, pageFrame->age, frame);
+    }
+}
+
+/**
+ * @brief Appends a frame to the tail of a frame list.
+ *
+ * @param[in,out] pageTable Page table of the process
+ *
+ * @param[in] listIndex List to add to
+ *
+ * @param[in] frame Frame to add
+ *
+ * @return none
+ */
+void addFrameToList(PageTable *pageTable, int listIndex, int frame)
+{
+    FrameList *frameList = &pageTable->frameLists[listIndex];
+    PageFrame *frameTable = pageTable->frameTable;
+
+    frameTable[frame].prev = frameList->tail;
+    frameTable[frame].next = NO_FRAME;
+
+    if(frameList->tail == NO_FRAME)
+    {
+        frameList->head = frame;
+    }
+    else
+    {
+        frameTable[frameList->tail].next = frame;
+    }
+
+    frameList->tail = frame;
+}
+
+/**
+ * @brief Unlinks a frame from a frame list.
+ *
+ * @param[in,out] pageTable Page table of the process
+ *
+ * @param[in] listIndex List the frame is on
+ *
+ * @param[in] frame Frame to remove
+ *
+ * @return none
+ */
+void removeFrameFromList(PageTable *pageTable, int listIndex, int frame)
+{
+    FrameList *frameList = &pageTable->frameLists[listIndex];
+    PageFrame *frameTable = pageTable->frameTable;
+
+    if(frameTable[frame].prev == NO_FRAME)
+    {
+        frameList->head = frameTable[frame].next;
+    }
+    else
+    {
+        frameTable[frameTable[frame].prev].next = frameTable[frame].next;
+    }
+
+    if(frameTable[frame].next == NO_FRAME)
+    {
+        frameList->tail = frameTable[frame].prev;
+    }
+    else
+    {
+        frameTable[frameTable[frame].next].prev = frameTable[frame].prev;
+    }
+}
+
+/**
+ * @brief Finds a page's entry in its TLB set, marking it used.
+ *
+ * @param[in] procNum Process making the access
+ *
+ * @param[in] page Virtual page to look up
+ *
+ * @return Entry found, NULL on a miss
+ */
+TlbEntry *findTlbEntry(int procNum, int page)
+{
+    TlbEntry *set = &tlb.entries[(page % tlb.numSets) * tlb.numWays];
+    int way;
+
+    for(way = 0; way < tlb.numWays; way++)
+    {
+        if(set[way].procNum == procNum && set[way].page == page)
+        {
+            tlb.useCount++;
+            set[way].lastUse = tlb.useCount;
+
+            return &set[way];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Puts a translation in its TLB set.
+ *
+ * @details Takes an empty way if there is one, otherwise the least
+ *          recently used.
+ *
+ * @param[in] procNum Process owning the page
+ *
+ * @param[in] page Virtual page
+ *
+ * @param[in] frame Frame the page is in
+ *
+ * @return none
+ */
+void addTlbEntry(int procNum, int page, int frame)
+{
+    TlbEntry *set = &tlb.entries[(page % tlb.numSets) * tlb.numWays];
+    TlbEntry *victim = &set[0];
+    int way;
+
+    for(way = 0; way < tlb.numWays; way++)
+    {
+        if(set[way].procNum == -1)
+        {
+            victim = &set[way];
+            break;
+        }
+
+        if(set[way].lastUse < victim->lastUse)
+        {
+            victim = &set[way];
+        }
+    }
+
+    tlb.useCount++;
+    victim->procNum = procNum;
+    victim->page = page;
+    victim->frame = frame;
+    victim->lastUse = tlb.useCount;
+}
+
+/**
+ * @brief Drops the translation of an evicted page from the TLB.
+ *
+ * @param[in] procNum Process owning the page
+ *
+ * @param[in] page Virtual page evicted
+ *
+ * @return none
+ */
+void dropTlbEntry(int procNum, int page)
+{
+    TlbEntry *set = &tlb.entries[(page % tlb.numSets) * tlb.numWays];
+    int way;
+
+    for(way = 0; way < tlb.numWays; way++)
+    {
+        if(set[way].procNum == procNum && set[way].page == page)
+        {
+            set[way].procNum = -1;
+        }
+    }
+}
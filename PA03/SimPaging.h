@@ -0,0 +1,104 @@
+#ifndef SIM_PAGING_H
+#define SIM_PAGING_H
+
+#include <stdlib.h>
+#include "StringUtils.h"
+#include "ConfigAccess.h"
+#include "SimPhysMem.h"
+
+// constants for the paging model
+extern const int NO_FRAME;
+extern const int NO_PAGE;
+extern const int MAX_VIRTUAL_KB;
+extern const double TLB_LOOKUP_NSEC;
+extern const double MEM_ACCESS_NSEC;
+
+// constants for aging replacement, one frame list per age value
+extern const int NUM_AGES;
+extern const int NEW_PAGE_AGE;
+
+// one page frame of a process; prev and next link it into the
+// recency list under LRU or the list of its age under aging
+typedef struct
+{
+    int page;
+    int block;          // physical memory the frame is in
+    int prev;
+    int next;
+    unsigned char referenced;
+    unsigned char age;
+} PageFrame;
+
+typedef struct
+{
+    int head;
+    int tail;
+} FrameList;
+
+// page table of a process, mapping each virtual page to a frame, and
+// the frames it holds; both are made on its first access
+typedef struct
+{
+    int *frames;
+    int numPages;
+    PageFrame *frameTable;
+    FrameList *frameLists;
+    int numFrames;      // room in the frame table, one per page
+    int framesUsed;
+    int hand;           // next frame FIFO or CLOCK looks at
+    int accessesToTick; // accesses left before pages are aged
+} PageTable;
+
+// one TLB entry, tagged with the owning process and virtual page
+typedef struct
+{
+    int procNum;
+    int page;
+    int frame;
+    long lastUse;
+} TlbEntry;
+
+// set-associative TLB shared by all processes
+typedef struct
+{
+    TlbEntry *entries;
+    int numSets;
+    int numWays;
+    long useCount;
+} Tlb;
+
+// paging counts of one process
+typedef struct
+{
+    long accesses;
+    long tlbHits;
+    long pageWalks;
+    long pageFaults;
+    long evictions;
+    long faultMSec;
+    double latencyNSec;
+} PagingStats;
+
+// function prototypes
+void startPaging(ConfigDataType *configData, int numProcesses);
+void stopPaging(void);
+Boolean isPagingOn(void);
+PagingStats *getPagingStats(int *numProcesses);
+void initPageTable(PageTable *pageTable);
+void clearPageTable(PageTable *pageTable, int procNum);
+Boolean accessPage(PageTable *pageTable, int procNum, int virtualKB,
+                                                            int *faultMSec);
+int walkPageTable(PageTable *pageTable, int procNum, int page,
+                                        PagingStats *stats, int *faultMSec);
+void allocFrameTable(PageTable *pageTable);
+int findVictimFrame(PageTable *pageTable);
+void loadFrame(PageTable *pageTable, int frame, int page);
+void touchFrame(PageTable *pageTable, int frame);
+void ageFrames(PageTable *pageTable);
+void addFrameToList(PageTable *pageTable, int listIndex, int frame);
+void removeFrameFromList(PageTable *pageTable, int listIndex, int frame);
+TlbEntry *findTlbEntry(int procNum, int page);
+void addTlbEntry(int procNum, int page, int frame);
+void dropTlbEntry(int procNum, int page);
+
+#endif // SIM_PAGING_H
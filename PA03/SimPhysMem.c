@@ -0,0 +1,474 @@
+// Header files
+#include "SimPhysMem.h"
+
+// blocks of orders below this, up to 32 KB, are cached per core; a
+// cache holds at most MEM_CACHE_SIZE of each and moves them to and from
+// the pool MEM_CACHE_BATCH at a time
+const int NUM_CACHED_ORDERS = 6;
+const int MEM_CACHE_SIZE = 16;
+const int MEM_CACHE_BATCH = 8;
+const int MAX_MEM_CACHES = 64;
+
+// Physical memory manager ///////////////////////////////////////////////////
+
+// All processes allocate from one buddy pool the size of Memory
+// Available (KB). The pool has a single lock, so each core keeps a
+// small cache of free blocks: a thread takes and returns blocks through
+// the cache it was assigned, going to the pool only to refill or flush
+// a batch. Before an allocation is failed, every cache is drained back
+// into the pool so that blocks they hold can join their buddies; only
+// a pool that still has no block big enough is exhausted.
+
+static PhysMemory physMemory;
+
+/**
+ * @brief Sets up physical memory and a free block cache per core.
+ *
+ * @param[in] totalKB Size of physical memory in KB
+ *
+ * @return none
+ */
+void startPhysMemory(int totalKB)
+{
+    long onlineCpus = sysconf(_SC_NPROCESSORS_ONLN);
+    MemCache *cache;
+    int index, order;
+
+    createBuddyPool(&physMemory.pool, totalKB);
+    pthread_mutex_init(&physMemory.poolLock, NULL);
+
+    physMemory.numCaches = onlineCpus > 0 ? (int)onlineCpus : 1;
+
+    if(physMemory.numCaches > MAX_MEM_CACHES)
+    {
+        physMemory.numCaches = MAX_MEM_CACHES;
+    }
+
+    physMemory.caches = (MemCache *)malloc(physMemory.numCaches
+                                                        * sizeof(MemCache));
+
+    for(index = 0; index < physMemory.numCaches; index++)
+    {
+        cache = &physMemory.caches[index];
+
+        pthread_mutex_init(&cache->lock, NULL);
+        cache->counts = (int *)malloc(NUM_CACHED_ORDERS * sizeof(int));
+        cache->blocks = (int *)malloc(NUM_CACHED_ORDERS * MEM_CACHE_SIZE
+                                                            * sizeof(int));
+        cache->hits = 0;
+        cache->refills = 0;
+        cache->flushes = 0;
+        cache->frag = (FragStats){ 0, 0.0, 0.0, 0.0, 0.0 };
+
+        for(order = 0; order < NUM_CACHED_ORDERS; order++)
+        {
+            cache->counts[order] = 0;
+        }
+    }
+
+    pthread_key_create(&physMemory.cacheKey, NULL);
+    physMemory.nextCache = 0;
+    physMemory.usedKB = 0;
+    physMemory.requestedKB = 0;
+    physMemory.cachedKB = 0;
+    physMemory.peakUsedKB = 0;
+    physMemory.allocations = 0;
+    physMemory.failures = 0;
+    physMemory.frees = 0;
+
+    publishPoolState();
+}
+
+/**
+ * @brief Frees physical memory and its caches.
+ *
+ * @return none
+ */
+void stopPhysMemory(void)
+{
+    int index;
+
+    for(index = 0; index < physMemory.numCaches; index++)
+    {
+        pthread_mutex_destroy(&physMemory.caches[index].lock);
+        free(physMemory.caches[index].counts);
+        free(physMemory.caches[index].blocks);
+    }
+
+    free(physMemory.caches);
+    pthread_key_delete(physMemory.cacheKey);
+    pthread_mutex_destroy(&physMemory.poolLock);
+    freeBuddyPool(&physMemory.pool);
+}
+
+/**
+ * @brief Gives physical memory, for reporting once the run is over.
+ *
+ * @return Physical memory
+ */
+PhysMemory *getPhysMemory(void)
+{
+    return &physMemory;
+}
+
+/**
+ * @brief Gives the size of physical memory.
+ *
+ * @return Size in KB
+ */
+int getPhysMemoryKB(void)
+{
+    return physMemory.pool.totalKB;
+}
+
+/**
+ * @brief Gives the free physical memory, in the pool or cached.
+ *
+ * @details Read without the pool lock, so it may be slightly stale.
+ *
+ * @return Free KB
+ */
+int getFreePhysMemoryKB(void)
+{
+    return __atomic_load_n(&physMemory.poolFreeKB, __ATOMIC_RELAXED)
+            + __atomic_load_n(&physMemory.cachedKB, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Allocates a block of physical memory of at least a size.
+ *
+ * @details Safe to call from any thread. A cached order is taken from
+ *          the calling core's cache, refilled from the pool when empty.
+ *
+ * @param[in] sizeKB KB asked for, at least 1
+ *
+ * @return Address of the block in KB, NO_BLOCK when memory is exhausted
+ */
+int allocPhysMemory(int sizeKB)
+{
+    MemCache *cache = getMemCache();
+    int order = getBlockOrder(sizeKB);
+    int block = NO_BLOCK;
+    int usedKB;
+
+    pthread_mutex_lock(&cache->lock);
+
+    if(order < NUM_CACHED_ORDERS)
+    {
+        if(cache->counts[order] > 0)
+        {
+            cache->hits++;
+        }
+        else
+        {
+            refillMemCache(cache, order);
+        }
+
+        if(cache->counts[order] > 0)
+        {
+            cache->counts[order]--;
+            block = cache->blocks[order * MEM_CACHE_SIZE
+                                                    + cache->counts[order]];
+            __atomic_sub_fetch(&physMemory.cachedKB, 1 << order,
+                                                        __ATOMIC_RELAXED);
+        }
+    }
+    else
+    {
+        pthread_mutex_lock(&physMemory.poolLock);
+        block = allocBuddyBlock(&physMemory.pool, sizeKB);
+        publishPoolState();
+        pthread_mutex_unlock(&physMemory.poolLock);
+    }
+
+    pthread_mutex_unlock(&cache->lock);
+
+    // memory may be held by caches; give it all back and try once more
+    if(block == NO_BLOCK)
+    {
+        drainMemCaches();
+
+        pthread_mutex_lock(&physMemory.poolLock);
+        block = allocBuddyBlock(&physMemory.pool, sizeKB);
+        publishPoolState();
+        pthread_mutex_unlock(&physMemory.poolLock);
+    }
+
+    if(block == NO_BLOCK)
+    {
+        __atomic_add_fetch(&physMemory.failures, 1, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_add_fetch(&physMemory.allocations, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&physMemory.requestedKB, sizeKB, __ATOMIC_RELAXED);
+        usedKB = __atomic_add_fetch(&physMemory.usedKB, 1 << order,
+                                                        __ATOMIC_RELAXED);
+        updatePeakUsed(usedKB);
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    sampleFragmentation(cache);
+    pthread_mutex_unlock(&cache->lock);
+
+    return block;
+}
+
+/**
+ * @brief Frees a block of physical memory.
+ *
+ * @details Safe to call from any thread. A cached order goes to the
+ *          calling core's cache, which flushes a batch when full.
+ *
+ * @param[in] block Address of the block
+ *
+ * @param[in] sizeKB KB asked for when the block was allocated
+ *
+ * @return none
+ */
+void freePhysMemory(int block, int sizeKB)
+{
+    MemCache *cache = getMemCache();
+    int order = getBlockOrder(sizeKB);
+
+    __atomic_add_fetch(&physMemory.frees, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&physMemory.requestedKB, sizeKB, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&physMemory.usedKB, 1 << order, __ATOMIC_RELAXED);
+
+    pthread_mutex_lock(&cache->lock);
+
+    if(order < NUM_CACHED_ORDERS)
+    {
+        if(cache->counts[order] == MEM_CACHE_SIZE)
+        {
+            flushMemCache(cache, order, MEM_CACHE_BATCH);
+        }
+
+        cache->blocks[order * MEM_CACHE_SIZE + cache->counts[order]] = block;
+        cache->counts[order]++;
+        __atomic_add_fetch(&physMemory.cachedKB, 1 << order,
+                                                        __ATOMIC_RELAXED);
+    }
+    else
+    {
+        pthread_mutex_lock(&physMemory.poolLock);
+        freeBuddyBlock(&physMemory.pool, block);
+        publishPoolState();
+        pthread_mutex_unlock(&physMemory.poolLock);
+    }
+
+    sampleFragmentation(cache);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+/**
+ * @brief Finds the cache of the calling thread's core.
+ *
+ * @details Threads are spread over the caches in the order they first
+ *          allocate, one cache per online core.
+ *
+ * @return Cache of the calling thread
+ */
+MemCache *getMemCache(void)
+{
+    MemCache *cache = (MemCache *)pthread_getspecific(physMemory.cacheKey);
+    int index;
+
+    if(cache == NULL)
+    {
+        index = __atomic_fetch_add(&physMemory.nextCache, 1,
+                                    __ATOMIC_RELAXED) % physMemory.numCaches;
+        cache = &physMemory.caches[index];
+        pthread_setspecific(physMemory.cacheKey, cache);
+    }
+
+    return cache;
+}
+
+/**
+ * @brief Takes a batch of blocks of one order from the pool.
+ *
+ * @details Caller holds the cache's lock.
+ *
+ * @param[in,out] cache Cache to fill
+ *
+ * @param[in] order Order of the blocks
+ *
+ * @return none
+ */
+void refillMemCache(MemCache *cache, int order)
+{
+    int *orderBlocks = &cache->blocks[order * MEM_CACHE_SIZE];
+    int block;
+
+    pthread_mutex_lock(&physMemory.poolLock);
+
+    while(cache->counts[order] < MEM_CACHE_BATCH)
+    {
+        block = allocBuddyBlock(&physMemory.pool, 1 << order);
+
+        if(block == NO_BLOCK)
+        {
+            break;
+        }
+
+        orderBlocks[cache->counts[order]] = block;
+        cache->counts[order]++;
+        __atomic_add_fetch(&physMemory.cachedKB, 1 << order,
+                                                        __ATOMIC_RELAXED);
+    }
+
+    publishPoolState();
+    pthread_mutex_unlock(&physMemory.poolLock);
+
+    cache->refills++;
+}
+
+/**
+ * @brief Gives blocks of one order back to the pool.
+ *
+ * @details Caller holds the cache's lock.
+ *
+ * @param[in,out] cache Cache to empty from
+ *
+ * @param[in] order Order of the blocks
+ *
+ * @param[in] count Number of blocks to give back
+ *
+ * @return none
+ */
+void flushMemCache(MemCache *cache, int order, int count)
+{
+    int *orderBlocks = &cache->blocks[order * MEM_CACHE_SIZE];
+
+    if(count == 0)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&physMemory.poolLock);
+
+    while(count > 0 && cache->counts[order] > 0)
+    {
+        cache->counts[order]--;
+        freeBuddyBlock(&physMemory.pool, orderBlocks[cache->counts[order]]);
+        __atomic_sub_fetch(&physMemory.cachedKB, 1 << order,
+                                                        __ATOMIC_RELAXED);
+        count--;
+    }
+
+    publishPoolState();
+    pthread_mutex_unlock(&physMemory.poolLock);
+
+    cache->flushes++;
+}
+
+/**
+ * @brief Gives every cached block back to the pool.
+ *
+ * @details Caller holds no cache lock; caches are locked one at a time,
+ *          always before the pool lock.
+ *
+ * @return none
+ */
+void drainMemCaches(void)
+{
+    MemCache *cache;
+    int index, order;
+
+    for(index = 0; index < physMemory.numCaches; index++)
+    {
+        cache = &physMemory.caches[index];
+
+        pthread_mutex_lock(&cache->lock);
+
+        for(order = 0; order < NUM_CACHED_ORDERS; order++)
+        {
+            flushMemCache(cache, order, cache->counts[order]);
+        }
+
+        pthread_mutex_unlock(&cache->lock);
+    }
+}
+
+/**
+ * @brief Copies the pool's free space where it can be read unlocked.
+ *
+ * @details Caller holds the pool lock.
+ *
+ * @return none
+ */
+void publishPoolState(void)
+{
+    __atomic_store_n(&physMemory.poolFreeKB, physMemory.pool.freeKB,
+                                                        __ATOMIC_RELAXED);
+    __atomic_store_n(&physMemory.largestFreeKB,
+                    getLargestFreeKB(&physMemory.pool), __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Raises the peak of memory in use if it was passed.
+ *
+ * @param[in] usedKB KB in use after an allocation
+ *
+ * @return none
+ */
+void updatePeakUsed(int usedKB)
+{
+    int peakKB = __atomic_load_n(&physMemory.peakUsedKB, __ATOMIC_RELAXED);
+
+    while(usedKB > peakKB
+            && __atomic_compare_exchange_n(&physMemory.peakUsedKB, &peakKB,
+                    usedKB, False, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == 0)
+    {
+    }
+}
+
+/**
+ * @brief Records fragmentation after an allocation or free.
+ *
+ * @details Internal fragmentation is the share of KB in allocated
+ *          blocks beyond what was asked for; external is the share of
+ *          the pool's free KB outside its largest free block. Blocks
+ *          held by the caches are left out of both, as they cannot be
+ *          merged until flushed. Caller holds the cache's lock.
+ *
+ * @param[in,out] cache Cache of the thread making the change
+ *
+ * @return none
+ */
+void sampleFragmentation(MemCache *cache)
+{
+    FragStats *frag = &cache->frag;
+    int usedKB = __atomic_load_n(&physMemory.usedKB, __ATOMIC_RELAXED);
+    int requestedKB = __atomic_load_n(&physMemory.requestedKB,
+                                                        __ATOMIC_RELAXED);
+    int freeKB = __atomic_load_n(&physMemory.poolFreeKB, __ATOMIC_RELAXED);
+    int largestFreeKB = __atomic_load_n(&physMemory.largestFreeKB,
+                                                        __ATOMIC_RELAXED);
+    double internal = 0.0, external = 0.0;
+
+    if(usedKB > 0)
+    {
+        internal = 100.0 * (usedKB - requestedKB) / usedKB;
+    }
+
+    if(freeKB > largestFreeKB)
+    {
+        external = 100.0 * (freeKB - largestFreeKB) / freeKB;
+    }
+
+    frag->samples++;
+    frag->internalSum += internal;
+    frag->externalSum += external;
+
+    if(internal > frag->internalPeak)
+    {
+        frag->internalPeak = internal;
+    }
+
+    if(external > frag->externalPeak)
+    {
+        frag->externalPeak = external;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef SIM_PHYS_MEM_H
+#define SIM_PHYS_MEM_H
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "StringUtils.h"
+#include "SimBuddy.h"
+
+// constants for the per-core free block caches
+extern const int NUM_CACHED_ORDERS;
+extern const int MEM_CACHE_SIZE;
+extern const int MEM_CACHE_BATCH;
+extern const int MAX_MEM_CACHES;
+
+// fragmentation sampled as percentages after every allocation and free
+typedef struct
+{
+    long samples;
+    double internalSum;
+    double internalPeak;
+    double externalSum;
+    double externalPeak;
+} FragStats;
+
+// free blocks of the smaller orders held back for one core, so most
+// allocations and frees take only this cache's lock
+typedef struct
+{
+    pthread_mutex_t lock;
+    int *counts;        // blocks held, per order
+    int *blocks;        // MEM_CACHE_SIZE slots per order
+    long hits;
+    long refills;
+    long flushes;
+    FragStats frag;
+} MemCache;
+
+// physical memory shared by every process; the counters are updated
+// atomically so none of them needs the pool lock
+typedef struct
+{
+    BuddyPool pool;
+    pthread_mutex_t poolLock;
+    MemCache *caches;
+    int numCaches;
+    pthread_key_t cacheKey;
+    int nextCache;
+    int usedKB;         // KB in blocks given out
+    int requestedKB;    // KB asked for by those allocations
+    int cachedKB;       // KB in blocks held by caches
+    int poolFreeKB;     // pool state as of its last change
+    int largestFreeKB;
+    int peakUsedKB;
+    long allocations;
+    long failures;
+    long frees;
+} PhysMemory;
+
+// function prototypes
+void startPhysMemory(int totalKB);
+void stopPhysMemory(void);
+PhysMemory *getPhysMemory(void);
+int getPhysMemoryKB(void);
+int getFreePhysMemoryKB(void);
+int allocPhysMemory(int sizeKB);
+void freePhysMemory(int block, int sizeKB);
+MemCache *getMemCache(void);
+void refillMemCache(MemCache *cache, int order);
+void flushMemCache(MemCache *cache, int order, int count);
+void drainMemCaches(void);
+void publishPoolState(void);
+void updatePeakUsed(int usedKB);
+void sampleFragmentation(MemCache *cache);
+
+#endif // SIM_PHYS_MEM_H
@@ -0,0 +1,318 @@
+// Header files
+#include "SimScheduler.h"
+
+// Ready queue ////////////////////////////////////////////////////////////////
+
+// The preemptive dispatcher keeps every READY process here and asks the
+// queue which one runs next. SRTF-P keeps a binary min-heap ordered on
+// time remaining, so adding, selecting and checking for a preempting
+// process cost at most O(log n). Equal times run in the order the
+// processes became ready, which keeps runs reproducible. RR-P and FCFS-P
+// keep a ring buffer in ready order instead, so a process returning
+// from I/O, or whose quantum runs out, goes to the tail in O(1). A
+// process is never queued twice, so room for every process is all
+// either layout needs.
+
+/**
+ * @brief Creates an empty ready queue.
+ *
+ * @param[out] readyQueue Ready queue to create
+ *
+ * @param[in] cpuSchedCode Scheduling code the queue orders for
+ *
+ * @param[in] quantumCycles Cycles in an RR-P time slice; a quantum
+ *            of zero is taken as one cycle
+ *
+ * @param[in] capacity Most processes that can be ready at once
+ *
+ * @return none
+ */
+void createReadyQueue(ReadyQueue *readyQueue, int cpuSchedCode,
+                                            int quantumCycles, int capacity)
+{
+    readyQueue->cpuSchedCode = cpuSchedCode;
+    readyQueue->quantumCycles = quantumCycles > 0 ? quantumCycles : 1;
+    readyQueue->entries = (ReadyEntry *)malloc((capacity > 0 ? capacity : 1)
+                                                       * sizeof(ReadyEntry));
+    readyQueue->head = 0;
+    readyQueue->count = 0;
+    readyQueue->capacity = capacity;
+    readyQueue->sequence = 0;
+}
+
+/**
+ * @brief Frees a ready queue's entries.
+ *
+ * @param[in,out] readyQueue Ready queue to free
+ *
+ * @return none
+ */
+void freeReadyQueue(ReadyQueue *readyQueue)
+{
+    free(readyQueue->entries);
+
+    readyQueue->entries = NULL;
+    readyQueue->count = 0;
+}
+
+/**
+ * @brief Tells whether any process is ready.
+ *
+ * @param[in] readyQueue Ready queue to check
+ *
+ * @return True if no process is ready, False otherwise
+ */
+Boolean isReadyQueueEmpty(ReadyQueue *readyQueue)
+{
+    return readyQueue->count == 0 ? True : False;
+}
+
+/**
+ * @brief Adds a process that has just become READY.
+ *
+ * @param[in,out] readyQueue Ready queue to add to
+ *
+ * @param[in] readyPcb Ready process, which must not change its
+ *            time remaining while queued
+ *
+ * @return none
+ */
+void addReadyPcb(ReadyQueue *readyQueue, ProcessControlBlock *readyPcb)
+{
+    ReadyEntry newEntry;
+
+    newEntry.pcb = readyPcb;
+    newEntry.sequence = readyQueue->sequence;
+
+    readyQueue->sequence++;
+
+    if(readyQueue->cpuSchedCode == CPU_SCHED_SRTF_P_CODE)
+    {
+        addToHeap(readyQueue, newEntry);
+    }
+    else
+    {
+        addToRing(readyQueue, newEntry);
+    }
+}
+
+/**
+ * @brief Removes the process that should run next.
+ *
+ * @param[in,out] readyQueue Ready queue, which must not be empty
+ *
+ * @return Next process to run
+ */
+ProcessControlBlock *takeReadyPcb(ReadyQueue *readyQueue)
+{
+    if(readyQueue->cpuSchedCode == CPU_SCHED_SRTF_P_CODE)
+    {
+        return takeFromHeap(readyQueue);
+    }
+
+    return takeFromRing(readyQueue);
+}
+
+/**
+ * @brief Looks at the process that would run next without removing it.
+ *
+ * @param[in] readyQueue Ready queue to look at
+ *
+ * @return Next process, or NULL if none is ready
+ */
+ProcessControlBlock *peekReadyPcb(ReadyQueue *readyQueue)
+{
+    if(readyQueue->count == 0)
+    {
+        return NULL;
+    }
+
+    return readyQueue->entries[readyQueue->head].pcb;
+}
+
+/**
+ * @brief Tells whether a ready process should take over the CPU.
+ *
+ * @details Checked by the dispatcher after every CPU cycle and op,
+ *          once any interrupts have made their processes ready.
+ *          Under SRTF-P a ready process preempts the running one
+ *          only when it has strictly less time remaining. Under RR-P
+ *          the running process is preempted once it has used its
+ *          quantum and another process is waiting; with none waiting
+ *          it carries on into a new quantum. FCFS-P never preempts.
+ *
+ * @param[in] readyQueue Ready queue to check
+ *
+ * @param[in] runningPcb Process on the CPU
+ *
+ * @param[in] cyclesRun CPU cycles the process has run since selected
+ *
+ * @return True if the running process should be preempted
+ */
+Boolean isPreemptNeeded(ReadyQueue *readyQueue,
+                          ProcessControlBlock *runningPcb, int cyclesRun)
+{
+    ProcessControlBlock *nextPcb = peekReadyPcb(readyQueue);
+
+    if(nextPcb == NULL)
+    {
+        return False;
+    }
+
+    switch(readyQueue->cpuSchedCode)
+    {
+        case CPU_SCHED_SRTF_P_CODE:
+            return nextPcb->timeRemaining < runningPcb->timeRemaining
+                                                               ? True : False;
+
+        case CPU_SCHED_RR_P_CODE:
+            return cyclesRun >= readyQueue->quantumCycles ? True : False;
+    }
+
+    return False;
+}
+
+/**
+ * @brief Adds an entry to the heap.
+ *
+ * @details The entry is sifted up from the bottom of the heap.
+ *
+ * @param[in,out] readyQueue Ready queue holding the heap
+ *
+ * @param[in] newEntry Entry to add
+ *
+ * @return none
+ */
+void addToHeap(ReadyQueue *readyQueue, ReadyEntry newEntry)
+{
+    int index, parent;
+
+    index = readyQueue->count;
+
+    readyQueue->count++;
+
+    while(index > 0)
+    {
+        parent = (index - 1) / 2;
+
+        if(isBeforeInHeap(newEntry, readyQueue->entries[parent]) == False)
+        {
+            break;
+        }
+
+        readyQueue->entries[index] = readyQueue->entries[parent];
+
+        index = parent;
+    }
+
+    readyQueue->entries[index] = newEntry;
+}
+
+/**
+ * @brief Removes the top entry of the heap.
+ *
+ * @details The last entry is sifted down from the top of the heap.
+ *
+ * @param[in,out] readyQueue Ready queue holding a non-empty heap
+ *
+ * @return Process with the least time remaining
+ */
+ProcessControlBlock *takeFromHeap(ReadyQueue *readyQueue)
+{
+    ProcessControlBlock *nextPcb = readyQueue->entries[0].pcb;
+    ReadyEntry lastEntry;
+    int index = 0, child = 1;
+
+    readyQueue->count--;
+
+    lastEntry = readyQueue->entries[readyQueue->count];
+
+    while(child < readyQueue->count)
+    {
+        if(child + 1 < readyQueue->count
+             && isBeforeInHeap(readyQueue->entries[child + 1],
+                                       readyQueue->entries[child]) == True)
+        {
+            child++;
+        }
+
+        if(isBeforeInHeap(readyQueue->entries[child], lastEntry) == False)
+        {
+            break;
+        }
+
+        readyQueue->entries[index] = readyQueue->entries[child];
+
+        index = child;
+        child = 2 * index + 1;
+    }
+
+    readyQueue->entries[index] = lastEntry;
+
+    return nextPcb;
+}
+
+/**
+ * @brief Adds an entry at the tail of the ring.
+ *
+ * @param[in,out] readyQueue Ready queue holding the ring
+ *
+ * @param[in] newEntry Entry to add
+ *
+ * @return none
+ */
+void addToRing(ReadyQueue *readyQueue, ReadyEntry newEntry)
+{
+    int tail = readyQueue->head + readyQueue->count;
+
+    if(tail >= readyQueue->capacity)
+    {
+        tail -= readyQueue->capacity;
+    }
+
+    readyQueue->entries[tail] = newEntry;
+    readyQueue->count++;
+}
+
+/**
+ * @brief Removes the entry at the head of the ring.
+ *
+ * @param[in,out] readyQueue Ready queue holding a non-empty ring
+ *
+ * @return Process that has waited longest
+ */
+ProcessControlBlock *takeFromRing(ReadyQueue *readyQueue)
+{
+    ProcessControlBlock *nextPcb = readyQueue->entries[readyQueue->head].pcb;
+
+    readyQueue->head++;
+
+    if(readyQueue->head == readyQueue->capacity)
+    {
+        readyQueue->head = 0;
+    }
+
+    readyQueue->count--;
+
+    return nextPcb;
+}
+
+/**
+ * @brief Orders two heap entries.
+ *
+ * @param[in] oneEntry Entry to check
+ *
+ * @param[in] otherEntry Entry to check against
+ *
+ * @return True if oneEntry should run before otherEntry
+ */
+Boolean isBeforeInHeap(ReadyEntry oneEntry, ReadyEntry otherEntry)
+{
+    if(oneEntry.pcb->timeRemaining != otherEntry.pcb->timeRemaining)
+    {
+        return oneEntry.pcb->timeRemaining < otherEntry.pcb->timeRemaining
+                                                               ? True : False;
+    }
+
+    return oneEntry.sequence < otherEntry.sequence ? True : False;
+}
@@ -0,0 +1,46 @@
+#ifndef SIM_SCHEDULER_H
+#define SIM_SCHEDULER_H
+
+#include "StringUtils.h"
+#include "ConfigAccess.h"
+#include "SimUtils.h"
+
+// ready process with the order it became ready in, which breaks ties
+typedef struct
+{
+    ProcessControlBlock *pcb;
+    long sequence;
+} ReadyEntry;
+
+// ready queue of a preemptive scheduler; for SRTF-P the entries
+// form a binary min-heap on time remaining, for RR-P and FCFS-P a
+// ring buffer in ready order. Either way the next process to run
+// is at head, which the heap leaves at zero
+typedef struct ReadyQueue
+{
+    int cpuSchedCode;
+    int quantumCycles;
+    ReadyEntry *entries;
+    int head;
+    int count;
+    int capacity;
+    long sequence;
+} ReadyQueue;
+
+// function prototypes
+void createReadyQueue(ReadyQueue *readyQueue, int cpuSchedCode,
+                                            int quantumCycles, int capacity);
+void freeReadyQueue(ReadyQueue *readyQueue);
+Boolean isReadyQueueEmpty(ReadyQueue *readyQueue);
+void addReadyPcb(ReadyQueue *readyQueue, ProcessControlBlock *readyPcb);
+ProcessControlBlock *takeReadyPcb(ReadyQueue *readyQueue);
+ProcessControlBlock *peekReadyPcb(ReadyQueue *readyQueue);
+Boolean isPreemptNeeded(ReadyQueue *readyQueue,
+                          ProcessControlBlock *runningPcb, int cyclesRun);
+void addToHeap(ReadyQueue *readyQueue, ReadyEntry newEntry);
+ProcessControlBlock *takeFromHeap(ReadyQueue *readyQueue);
+void addToRing(ReadyQueue *readyQueue, ReadyEntry newEntry);
+ProcessControlBlock *takeFromRing(ReadyQueue *readyQueue);
+Boolean isBeforeInHeap(ReadyEntry oneEntry, ReadyEntry otherEntry);
+
+#endif // SIM_SCHEDULER_H
@@ -1,607 +1,1090 @@
 // Header files
+#include <unistd.h>     // for sysconf
 #include "SimUtils.h"
+#include "SimScheduler.h"
+
+// constants for the SJF sort: process count from which the sort is
+// split across threads, and the most threads it will use
+const int PARALLEL_SORT_MIN = 65536;
+const int MAX_SORT_THREADS = 8;
+
+// service queue of each I/O device, so ops on different devices
+// are serviced by different threads
+static WorkQueue deviceQueues[ NUM_IO_DEVICES ];
 
 /*
 Function:       startSimulator
 Algorithm:      starts up the simulator and creates necessary process control
                 blocks, set their states to ready, and run them starting with
                 the first (0) process
-Precondition:   configuration data and op code list are correctly configured
-                with no errors and the op code list is in the correct order
+Precondition:   configuration data and op table are correctly configured
+                with no errors and the op table is in the correct order
                 starting with S(start) -> A(start)
 Postcondition:  Simulator has ended after outputing the run
 Notes:           none
  */
-void runSimulator( ConfigDataType *configData, OpCodeType *opCodeList)
+void runSimulator( ConfigDataType *configData, OpTable *opTable )
 {
     // initialize variables and functions
-    LogString *logStringPtr = NULL;
-    char tempString[MAX_STR_LEN];
     char timerString[MAX_STR_LEN];
-    int numProcesses;
-    int logToCode = configData->logToCode;
+    PcbTable pcbTable;
+    int *runOrder;
+
+    // open log and create log file header if necessary
+    openSimLog(configData);
 
-    // create log file header if necessary
-    if(logToCode != LOGTO_MONITOR_CODE)
+    outputLine("\n==================================\n");
+    outputLine("Begin Simulation\n\n");
+
+    // select real or virtual time before the clock starts
+    if( configData->timerModeCode == TIMER_VIRTUAL_CODE )
     {
-        logStringPtr = createLogFileHeader(configData, logStringPtr);
+        setTimerMode( VIRTUAL_TIMER_MODE );
+    }
+    else if( configData->timerModeCode == TIMER_PACED_CODE )
+    {
+        setTimerMode( PACED_TIMER_MODE );
+    }
+    else
+    {
+        setTimerMode( REAL_TIMER_MODE );
     }
 
-    logStringPtr = outputLine(logToCode, logStringPtr,
-                                                         "\n==================================\n");
-    logStringPtr = outputLine(logToCode, logStringPtr,
-                                                        "Begin Simulation\n\n");
-
-    // begin timer and display system start
+    // begin timer, logger and I/O devices, display system start
     accessTimer(ZERO_TIMER, timerString);
-    sprintf(tempString, "  %s, OS: System Start\n", timerString);
-    logStringPtr = outputLine(logToCode, logStringPtr, tempString);
+    startLogger();
+    startDevices(configData);
+    logSimEvent(SYSTEM_START_EVENT, 0, 0);
+
+    // create process control blocks inside table and output message;
+    // paging is set up first, page tables are sized by page size
+    logSimEvent(CREATE_PCBS_EVENT, 0, 0);
+    startPhysMemory( configData->memAvailable );
+    startMemUnits();
+    startPaging( configData, opTable->numProcesses );
+    createPCBs( &pcbTable, configData, opTable );
 
-    // get next op command, system has been started
-    opCodeList = opCodeList->next;
+    // processes are initialized in new state
+    logSimEvent(PROCS_NEW_EVENT, 0, 0);
 
-    // create process control blocks inside array and output message
-    accessTimer(LAP_TIMER, timerString);
-    sprintf(tempString, "  %s, OS: Create Process Control Blocks\n", timerString);
-    logStringPtr = outputLine(logToCode, logStringPtr, tempString);
-    numProcesses = getNumProcesses( opCodeList );
-    ProcessControlBlock pcbArray[ numProcesses ];
-    createPCBs( pcbArray, configData, opCodeList );
+    // processes run in file order, unless shortest job first
+    // reorders them; pcbs stay where they are
+    runOrder = (int *) malloc( ( pcbTable.numPcbs > 0 ? pcbTable.numPcbs : 1 )
+                                                            * sizeof( int ) );
 
-    // processes are initialized in new state
-    accessTimer(LAP_TIMER, timerString);
-    sprintf(tempString, "  %s, OS: All Processes initialized in NEW state\n",
-                                                                       timerString);
-    logStringPtr = outputLine(logToCode, logStringPtr, tempString);
+    for( int index = 0; index < pcbTable.numPcbs; index++)
+    {
+        runOrder[ index ] = index;
+    }
 
-    // if shortest job first, sort accordingly
     if( configData->cpuSchedCode == CPU_SCHED_SJF_N_CODE )
     {
-        sortForSJF( pcbArray, numProcesses );
+        sortForSJF( pcbTable.pcbs, runOrder, pcbTable.numPcbs );
     }
 
     // set all processes in 'ready' state.
-    for( int index = 0; index < numProcesses; index++)
+    for( int index = 0; index < pcbTable.numPcbs; index++)
     {
-        pcbArray[ index ].state = READY;
+        pcbTable.pcbs[ index ].state = READY;
     }
 
     // output processes ready message
-    accessTimer(LAP_TIMER, timerString);
-    sprintf(tempString, "  %s, OS: All Processes now set in READY state\n", timerString);
-    logStringPtr = outputLine(logToCode, logStringPtr, tempString);
+    logSimEvent(PROCS_READY_EVENT, 0, 0);
 
-    // run each process
-    for( int index = 0; index < numProcesses; index++)
+    // interleave processes under a preemptive scheduler,
+    // or run each process to its end in turn
+    if( configData->cpuSchedCode == CPU_SCHED_SRTF_P_CODE
+             || configData->cpuSchedCode == CPU_SCHED_FCFS_P_CODE
+             || configData->cpuSchedCode == CPU_SCHED_RR_P_CODE )
+    {
+        runPreemptive( &pcbTable, configData, opTable );
+    }
+    else
     {
-        runCurrPcb(pcbArray[index], configData, logStringPtr);
+        for( int index = 0; index < pcbTable.numPcbs; index++)
+        {
+            runCurrPcb(&pcbTable.pcbs[ runOrder[index] ], opTable);
+        }
     }
 
     //out of loop - system run has ended. output messages
-    accessTimer(LAP_TIMER, timerString);
-    sprintf(tempString, "  %s, OS: System Stop\n", timerString);
-    logStringPtr = outputLine(logToCode, logStringPtr, tempString);
+    free( runOrder );
+    freePcbTable( &pcbTable );
+    stopDevices();
+    logSimEvent(SYSTEM_STOP_EVENT, 0, 0);
+
+    // drain logger so remaining output is written in order
+    stopLogger();
+
+    // report how busy each I/O device was
+    outputDeviceReport(deviceQueues, NUM_IO_DEVICES);
 
-    logStringPtr = outputLine(logToCode, logStringPtr,
-                                                "\nEnd Simulation - Complete\n");
-    logStringPtr = outputLine(logToCode, logStringPtr,
-                                                "==================================\n");
-    // create log file if necessary
-    if(logToCode != LOGTO_MONITOR_CODE)
+    // report how physical memory was shared out, and how accesses
+    // were translated when memory is paged
+    outputMemoryReport( getPhysMemory() );
+
+    if( isPagingOn() == True )
     {
-        outputToFile(logStringPtr, configData->logToFileName);
+        outputPagingReport( configData );
     }
 
-    // clear log string
-    logStringPtr = clearLogString(logStringPtr);
+    stopPaging();
+    stopMemUnits();
+    stopPhysMemory();
+
+    // report how closely paced playback tracked simulated time
+    if( configData->timerModeCode == TIMER_PACED_CODE )
+    {
+        outputTimerDrift();
+    }
+
+    // stop the clock, releasing its event queue
+    accessTimer(STOP_TIMER, timerString);
+
+    outputLine("\nEnd Simulation - Complete\n");
+    outputLine("==================================\n");
+
+    // write out remaining lines and close log file
+    closeSimLog();
 }
 
 /*
 Func. Name:     createPCBs
-Algorithm:      iterates through op code list to identify and store
-                all program (A) and stores them seperate in a doubly linked
-                list
-pre-condition:  opCodeList is passed in at the first (A) program following the initial
-                (S) system start
-post-condition: pcb's will be linked through doubly linked list internally
-Notes:          For PA02 there is only one process and will create just one pcb
+Algorithm:      stores one process control block for each process (A) range
+                in the op table
+pre-condition:  op table holds the process ranges found by getOpCodes
+post-condition: pcb table holds one new pcb per process, in file order,
+                with its op range and total run time set
+Notes:          none
  */
 
-void createPCBs( ProcessControlBlock pcbArray[], ConfigDataType *configData, OpCodeType *opCodeList )
+void createPCBs( PcbTable *pcbTable, ConfigDataType *configData, OpTable *opTable )
 {
-    ProcessControlBlock newPcb;
-    int counter = 0;
+    ProcessControlBlock *newPcb;
+
+    createPcbTable( pcbTable, opTable->numProcesses );
 
-    while( isEndOfSim(opCodeList) == False )
+    for( int counter = 0; counter < opTable->numProcesses; counter++ )
     {
-        if( isProcessStart(opCodeList) == True )
-        {
-            newPcb.state = NEW;
-            newPcb.procNum = counter;
-            newPcb.progCntr= opCodeList;
-            newPcb.totalMemAvailable = configData->memAvailable;
-            newPcb.memOpHead = NULL;
-            newPcb.timeRemaining = setProcRuntimes( newPcb, configData->procCycleRate, configData->ioCycleRate );
-            pcbArray[ counter ] = newPcb;
-            counter++;
-        }
-        opCodeList = opCodeList->next;
+        newPcb = addPcb( pcbTable );
+        newPcb->state = NEW;
+        newPcb->procNum = counter;
+        newPcb->progCntr = opTable->procStart[ counter ];
+        newPcb->progEnd = opTable->procEnd[ counter ];
+        initMemIndex( &newPcb->memory->memIndex );
+        initPageTable( &newPcb->memory->pageTable );
+        newPcb->timeRemaining = setProcRuntimes( newPcb, opTable, configData->procCycleRate, configData->ioCycleRate );
     }
 }
 
-int getNumProcesses( OpCodeType *opCodeList )
+/*
+Function:       createPcbTable
+Algorithm:      allocates room on the heap for the given number of pcbs,
+                with their memory fields in a separate array
+Precondition:   none
+Postcondition:  pcb table is empty, with at least one slot of room
+Notes:          the fields scheduling touches on every op stay packed
+                together; memory lists are only reached through a pointer
+ */
+void createPcbTable( PcbTable *pcbTable, int capacity )
 {
-    int count = 0;
+    if( capacity < 1 )
+    {
+        capacity = 1;
+    }
 
-    while( isEndOfSim( opCodeList ) == False )
+    pcbTable->pcbs = (ProcessControlBlock *) malloc(
+                                    capacity * sizeof( ProcessControlBlock ) );
+    pcbTable->memory = (PcbMemory *) malloc( capacity * sizeof( PcbMemory ) );
+    pcbTable->numPcbs = 0;
+    pcbTable->capacity = capacity;
+}
+
+/*
+Function:       addPcb
+Algorithm:      takes the next slot of the table, doubling the table when
+                it is full and pointing each pcb back at its memory fields
+Precondition:   pcb table is created
+Postcondition:  returns the new pcb, linked to its own memory fields
+Notes:          growing moves the table, so pointers to pcbs are only
+                taken once every process has been added
+ */
+ProcessControlBlock *addPcb( PcbTable *pcbTable )
+{
+    ProcessControlBlock *newPcb;
+
+    if( pcbTable->numPcbs == pcbTable->capacity )
     {
-        if( isProcessStart( opCodeList ) == True )
+        pcbTable->capacity *= 2;
+
+        pcbTable->pcbs = (ProcessControlBlock *) realloc( pcbTable->pcbs,
+                          pcbTable->capacity * sizeof( ProcessControlBlock ) );
+        pcbTable->memory = (PcbMemory *) realloc( pcbTable->memory,
+                                    pcbTable->capacity * sizeof( PcbMemory ) );
+
+        for( int index = 0; index < pcbTable->numPcbs; index++ )
         {
-            count++;
+            pcbTable->pcbs[ index ].memory = &pcbTable->memory[ index ];
         }
-        opCodeList = opCodeList->next;
     }
-    return count;
+
+    newPcb = &pcbTable->pcbs[ pcbTable->numPcbs ];
+    newPcb->memory = &pcbTable->memory[ pcbTable->numPcbs ];
+
+    pcbTable->numPcbs++;
+
+    return newPcb;
 }
 
-Boolean isProcessStart( OpCodeType *opCodeList )
+/*
+    clears each pcb's memory list and frees the table
+ */
+void freePcbTable( PcbTable *pcbTable )
 {
-    if( opCodeList->opLtr == 'A'
-        && compareString( opCodeList->opName, "start" ) == STR_EQ )
+    for( int index = 0; index < pcbTable->numPcbs; index++ )
     {
-        return True;
+        clearMemoryList( &pcbTable->memory[ index ].memIndex );
+        clearPageTable( &pcbTable->memory[ index ].pageTable, index );
     }
-    return False;
+
+    free( pcbTable->pcbs );
+    free( pcbTable->memory );
+
+    pcbTable->pcbs = NULL;
+    pcbTable->memory = NULL;
+    pcbTable->numPcbs = 0;
+    pcbTable->capacity = 0;
 }
 
 /*
-    adds up total runtime for passed in pcb and sets it to the pcb runtime var
+    sets run time of each op in the passed in pcb's range, and returns
+    the process total runtime for the pcb runtime var
  */
-double setProcRuntimes( ProcessControlBlock newPcb, int procRate, int ioRate )
+double setProcRuntimes( ProcessControlBlock *newPcb, OpTable *opTable, int procRate, int ioRate )
 {
-    double timeRemaining = 0.00;
-    OpCodeType *localPtr = newPcb.progCntr;
+    int opIndex;
 
-    while( isEndOfProcess( localPtr ) == False )
+    for( opIndex = newPcb->progCntr + 1; opIndex < newPcb->progEnd; opIndex++ )
     {
-        if( localPtr->opLtr == 'P')
+        if( opTable->opKind[ opIndex ] == PROCESS_RUN_OP )
+        {
+            opTable->timeRemaining[ opIndex ] = procRate * opTable->opValue[ opIndex ];
+        }
+        else if( isIoOp( opTable->opKind[ opIndex ] ) == True )
         {
-            localPtr->timeRemaining = procRate * localPtr->opValue;
-            timeRemaining += (double)localPtr->timeRemaining;
+            opTable->timeRemaining[ opIndex ] = ioRate * opTable->opValue[ opIndex ];
         }
-        else if( localPtr->opLtr == 'I' || localPtr->opLtr == 'O')
+        else
         {
-            localPtr->timeRemaining = ioRate * localPtr->opValue;
-            timeRemaining += (double)localPtr->timeRemaining;
+            opTable->timeRemaining[ opIndex ] = 0;
         }
-        localPtr = localPtr->next;
     }
-    return timeRemaining;
+    return (double)procRate * opTable->procCycles[ newPcb->procNum ]
+                + (double)ioRate * opTable->ioCycles[ newPcb->procNum ];
 }
 
 /*
-    Simple Bubble sort algorithm to order process control block
-    array into shortest run time process to longest run time process
+Function:       sortForSJF
+Algorithm:      stable merge sort of the run order on each process's total
+                run time; large counts are sorted in chunks by separate
+                threads, whose sorted runs are then merged
+Precondition:   run order holds each pcb index once
+Postcondition:  run order lists pcbs from shortest to longest run time,
+                with equal times left in their previous order
+Notes:          only indices move, pcbs are not copied
  */
-void sortForSJF( ProcessControlBlock pcbArray[], int numProcesses )
+void sortForSJF( ProcessControlBlock pcbArray[], int runOrder[], int numProcesses )
 {
-    ProcessControlBlock min, otherProc;
+    int *scratch;
+    int numThreads = 1, chunkSize, width, start;
+    long onlineCpus;
+    pthread_t sortThreads[ MAX_SORT_THREADS ];
+    SortRange sortRanges[ MAX_SORT_THREADS ];
 
-    for(int outerIndex = 0; outerIndex < numProcesses - 1; outerIndex++)
+    if( numProcesses < 2 )
     {
-        min = pcbArray[outerIndex];
+        return;
+    }
+
+    scratch = (int *) malloc( numProcesses * sizeof( int ) );
+
+    if( numProcesses >= PARALLEL_SORT_MIN )
+    {
+        onlineCpus = sysconf( _SC_NPROCESSORS_ONLN );
+
+        numThreads = onlineCpus < MAX_SORT_THREADS ? (int) onlineCpus
+                                                   : MAX_SORT_THREADS;
 
-        for(int innerIndex = outerIndex + 1; innerIndex < numProcesses; innerIndex++)
+        if( numThreads < 1 )
         {
-            otherProc = pcbArray[innerIndex];
-            if(otherProc.timeRemaining < min.timeRemaining)
-            {
-                swap(outerIndex, innerIndex, pcbArray);
-                min = pcbArray[outerIndex];
-            }
+            numThreads = 1;
+        }
+    }
+
+    chunkSize = ( numProcesses + numThreads - 1 ) / numThreads;
+
+    // each thread sorts its own chunk of the order, in place
+    for( int index = 0; index < numThreads; index++ )
+    {
+        sortRanges[ index ].pcbArray = pcbArray;
+        sortRanges[ index ].runOrder = runOrder;
+        sortRanges[ index ].scratch = scratch;
+        sortRanges[ index ].start = index * chunkSize;
+        sortRanges[ index ].end = ( index + 1 ) * chunkSize < numProcesses
+                                     ? ( index + 1 ) * chunkSize : numProcesses;
+
+        if( numThreads > 1 )
+        {
+            pthread_create( &sortThreads[ index ], NULL, runSortRange,
+                                                        &sortRanges[ index ] );
+        }
+    }
+
+    if( numThreads > 1 )
+    {
+        for( int index = 0; index < numThreads; index++ )
+        {
+            pthread_join( sortThreads[ index ], NULL );
         }
     }
+    else
+    {
+        runSortRange( &sortRanges[ 0 ] );
+    }
+
+    // merge neighbouring chunks until one sorted run is left
+    for( width = chunkSize; width < numProcesses; width *= 2 )
+    {
+        for( start = 0; start + width < numProcesses; start += 2 * width )
+        {
+            mergeRunOrder( pcbArray, runOrder, scratch, start, start + width,
+                      start + 2 * width < numProcesses ? start + 2 * width
+                                                       : numProcesses );
+        }
+    }
+
+    free( scratch );
 }
 
-void swap( int index1, int index2, ProcessControlBlock pcbArray[] )
+/*
+    sorts one range of the run order with a bottom up merge sort,
+    so no recursion is needed; runs as a sort thread for large counts
+ */
+void *runSortRange( void *range )
 {
-    ProcessControlBlock temp = pcbArray[index1];
-    pcbArray[index1] = pcbArray[index2];
-    pcbArray[index2] = temp;
+    SortRange *sortRange = (SortRange *) range;
+    int width, start, mid, end;
+
+    for( width = 1; width < sortRange->end - sortRange->start; width *= 2 )
+    {
+        for( start = sortRange->start; start + width < sortRange->end;
+                                                          start += 2 * width )
+        {
+            mid = start + width;
+            end = mid + width < sortRange->end ? mid + width : sortRange->end;
+
+            mergeRunOrder( sortRange->pcbArray, sortRange->runOrder,
+                                        sortRange->scratch, start, mid, end );
+        }
+    }
+
+    return NULL;
 }
 
 /*
-    function that is passed into pthread_create to run Input and Output
-    processes in OSSimulator
+    merges the sorted runs start..mid and mid..end of the run order;
+    on equal run times the earlier run goes first, keeping the sort stable
  */
-void *runThread( void *thread )
+void mergeRunOrder( ProcessControlBlock pcbArray[], int runOrder[],
+                               int scratch[], int start, int mid, int end )
 {
-    ThreadRunner *threadToRun = (ThreadRunner *) thread;
-    char *outString = threadToRun->opCode->opName;
-    char timerString[MAX_STR_LEN];
-    char tempString[MAX_STR_LEN];
+    int left = start, right = mid, index = start;
 
-    switch( threadToRun->opCode->opLtr )
+    while( left < mid && right < end )
     {
-        case 'P':
-            concatenateString(outString, " operation");
-            break;
-        case 'I':
-            concatenateString(outString, " input");
-            break;
-        case 'O':
-            concatenateString(outString, " output");
-            break;
+        if( pcbArray[ runOrder[ right ] ].timeRemaining
+                              < pcbArray[ runOrder[ left ] ].timeRemaining )
+        {
+            scratch[ index ] = runOrder[ right ];
+            right++;
+        }
+        else
+        {
+            scratch[ index ] = runOrder[ left ];
+            left++;
+        }
+
+        index++;
     }
 
-    accessTimer(LAP_TIMER, timerString);
-    sprintf(tempString, "  %s, Process: %d, %s start\n", timerString, threadToRun->procNum, outString);
-    threadToRun->logStringPtr = outputLine(threadToRun->logToCode, threadToRun->logStringPtr, tempString);
+    while( left < mid )
+    {
+        scratch[ index ] = runOrder[ left ];
+        left++;
+        index++;
+    }
 
-    runTimer(threadToRun->opCode->timeRemaining);
+    while( right < end )
+    {
+        scratch[ index ] = runOrder[ right ];
+        right++;
+        index++;
+    }
 
-    accessTimer(LAP_TIMER, timerString);
-    sprintf(tempString, "  %s, Process: %d, %s end\n", timerString, threadToRun->procNum, outString);
-    threadToRun->logStringPtr = outputLine(threadToRun->logToCode, threadToRun->logStringPtr, tempString);
+    for( index = start; index < end; index++ )
+    {
+        runOrder[ index ] = scratch[ index ];
+    }
+}
 
-    pthread_exit(NULL);
+/*
+    starts one service queue, with its threads, for each I/O device
+ */
+void startDevices( ConfigDataType *configData )
+{
+    for( int device = 0; device < NUM_IO_DEVICES; device++ )
+    {
+        startWorkQueue( &deviceQueues[ device ], configData->ioWorkerThreads,
+                                                    configData->ioQueueDepth );
+    }
 }
 
-void runCurrPcb( ProcessControlBlock currPcb, ConfigDataType *configData, LogString *logStringPtr )
+/*
+    stops each I/O device service queue once all I/O is done,
+    keeping its stats for the device report
+ */
+void stopDevices( void )
 {
-    char tempString[MAX_STR_LEN];
-    char timerString[MAX_STR_LEN];
-    Boolean segFaultOccurred;
+    for( int device = 0; device < NUM_IO_DEVICES; device++ )
+    {
+        stopWorkQueue( &deviceQueues[ device ] );
+    }
+}
 
-    ThreadRunner threadToRun;
-    threadToRun.logStringPtr = logStringPtr;
-    threadToRun.logToCode = configData->logToCode;
-    threadToRun.procNum = currPcb.procNum;
+/*
+    runs one Process, Input or Output operation in OSSimulator; run by
+    the dispatcher for P(run), and by a device service thread for I/O
+ */
+void *runOp( void *thread )
+{
+    ThreadRunner *threadToRun = (ThreadRunner *) thread;
+    OpTable *opTable = threadToRun->opTable;
+    int opIndex = threadToRun->opIndex;
+
+    logOpEvent( OP_START_EVENT, threadToRun->procNum, opIndex,
+                                                opTable->opKind[ opIndex ] );
+
+    runTimer(opTable->timeRemaining[ opIndex ]);
 
-    pthread_t tid;
-    pthread_attr_t tattr;
-    pthread_attr_init(&tattr);
+    logOpEvent( OP_END_EVENT, threadToRun->procNum, opIndex,
+                                                opTable->opKind[ opIndex ] );
+
+    return NULL;
+}
+
+void runCurrPcb( ProcessControlBlock *currPcb, OpTable *opTable )
+{
+    Boolean segFaultOccurred = False;
+    WorkItem opWork;
+    WorkQueue *opQueue;
+
+    ThreadRunner threadToRun;
+    threadToRun.procNum = currPcb->procNum;
+    threadToRun.opTable = opTable;
 
     // output process selection
-    accessTimer(LAP_TIMER, timerString);
-    sprintf(tempString, "  %s, OS: Process %d selected with %.0f ms remaining\n",
-                timerString, currPcb.procNum, currPcb.timeRemaining);
-    logStringPtr = outputLine(configData->logToCode, logStringPtr, tempString);
+    logSimEvent( PROC_SELECTED_EVENT, currPcb->procNum,
+                                    (int) currPcb->timeRemaining );
 
     // output process running
-    accessTimer(LAP_TIMER, timerString);
-    sprintf(tempString, "  %s, OS: Process %d set in RUNNING state\n\n", timerString,
-                                                        currPcb.procNum);
-    logStringPtr = outputLine(configData->logToCode, logStringPtr, tempString);
-    currPcb.state = RUNNING;
+    logSimEvent( PROC_RUNNING_EVENT, currPcb->procNum, 0 );
+    currPcb->state = RUNNING;
 
     // skip A(start) that is passed in
-    currPcb.progCntr = currPcb.progCntr->next;
+    currPcb->progCntr++;
 
-    while( isEndOfProcess( currPcb.progCntr ) == False )
+    while( currPcb->progCntr < currPcb->progEnd && segFaultOccurred == False )
     {
-        if( currPcb.progCntr->opLtr == 'M')
+        switch( opTable->opKind[ currPcb->progCntr ] )
         {
-             segFaultOccurred = runMemoryMgr( configData->logToCode, logStringPtr, currPcb );
+            case MEM_ALLOCATE_OP:
+            case MEM_ACCESS_OP:
+                segFaultOccurred = runMemoryMgr( currPcb, opTable );
+
+                if( segFaultOccurred == True )
+                {
+                    logSimEvent( SEG_FAULT_EVENT, currPcb->procNum, 0 );
+                }
+                break;
 
-            if( segFaultOccurred == True )
-            {
-                accessTimer( LAP_TIMER, timerString );
-                sprintf( tempString, "  %s, Process: %d, experiences segmentation fault\n",
-                                                timerString, currPcb.procNum );
-                logStringPtr = outputLine(configData->logToCode, logStringPtr, tempString);
+            case PROCESS_RUN_OP:
+            case INPUT_HARD_DRIVE_OP:
+            case INPUT_KEYBOARD_OP:
+            case INPUT_PRINTER_OP:
+            case INPUT_MONITOR_OP:
+            case OUTPUT_HARD_DRIVE_OP:
+            case OUTPUT_KEYBOARD_OP:
+            case OUTPUT_PRINTER_OP:
+            case OUTPUT_MONITOR_OP:
+                // Run op on the CPU, or on its device's service queue,
+                // then wait for it to finish
+                threadToRun.opIndex = currPcb->progCntr;
+
+                if( opTable->opKind[ currPcb->progCntr ] == PROCESS_RUN_OP )
+                {
+                    runOp( &threadToRun );
+                }
+                else
+                {
+                    opQueue = &deviceQueues[ getIoDevice( opTable->opKind[ currPcb->progCntr ] ) ];
+                    submitWork( opQueue, &opWork, runOp, &threadToRun );
+                    waitForWork( opQueue, &opWork );
+                }
+
+                // update time remaining for process
+                currPcb->timeRemaining -= opTable->timeRemaining[ currPcb->progCntr ];
                 break;
-            }
-        }
-        else
-        {
-            // Run thread
-            threadToRun.opCode = currPcb.progCntr;
-            pthread_create(&tid, &tattr, runThread, &threadToRun);
-            pthread_join(tid, NULL);
 
-            // update time remaining for process
-            currPcb.timeRemaining -= threadToRun.timeRemaining;
+            default:
+                // start and end ops inside a process have nothing to run
+                break;
         }
-        currPcb.progCntr = currPcb.progCntr->next;
+        currPcb->progCntr++;
     }
     // Clear memory list after each process run
-    currPcb.memOpHead = clearMemoryList(currPcb.memOpHead);
+    clearMemoryList( &currPcb->memory->memIndex );
+    clearPageTable( &currPcb->memory->pageTable, currPcb->procNum );
 
-    accessTimer( LAP_TIMER, timerString );
-    sprintf( tempString, "\n  %s, OS: Process %d ended and set in EXIT state\n",
-                                                timerString, currPcb.procNum );
-    logStringPtr = outputLine( configData->logToCode, logStringPtr, tempString );
-    currPcb.state = EXIT;
+    logSimEvent( PROC_EXIT_EVENT, currPcb->procNum, 0 );
+    currPcb->state = EXIT;
 }
 
-Boolean runMemoryMgr( int logToCode, LogString *logStringPtr, ProcessControlBlock currPcb )
+/*
+Function:       runPreemptive
+Algorithm:      runs all processes on the CPU under a preemptive scheduler;
+                P(run) ops run one cycle at a time, and an I/O op is posted
+                to its device while its process is BLOCKED and the CPU
+                moves on. Interrupts from finished I/O are serviced after
+                every cycle and op, and the ready queue then decides
+                whether the running process is preempted, by a shorter
+                process for SRTF-P or at the end of its quantum for RR-P;
+                FCFS-P gives up the CPU only to I/O or at its end
+Precondition:   pcbs are created and READY, and the I/O devices are started
+Postcondition:  every process has ended in EXIT state
+Notes:          the CPU idles only when every process left is blocked
+ */
+void runPreemptive( PcbTable *pcbTable, ConfigDataType *configData,
+                                                         OpTable *opTable )
 {
-    // variables and calculation to store memory data needed
-    int id = currPcb.progCntr->opValue / 1000000;
-    int base = (currPcb.progCntr->opValue / 1000) % 1000;
-    int offset = currPcb.progCntr->opValue % 1000;
-    char tempString[MAX_STR_LEN];
-    char timerString[MAX_STR_LEN];
-    Boolean segFaultOccurred = True;
+    ProcessControlBlock *pcbArray = pcbTable->pcbs;
+    int numProcesses = pcbTable->numPcbs;
+    ReadyQueue readyQueue;
+    IoRequest *ioRequests;
+    ProcessControlBlock *runningPcb = NULL;
+    int procsLeft = numProcesses, procsBlocked = 0;
+    int opIndex, cycleTime, cyclesRun = 0;
+    long ioSequence = 0;
+    Boolean opStarted = False;
+
+    ioRequests = (IoRequest *) malloc( ( numProcesses > 0 ? numProcesses : 1 )
+                                                        * sizeof( IoRequest ) );
+    createReadyQueue( &readyQueue, configData->cpuSchedCode,
+                                    configData->quantumCycles, numProcesses );
+
+    for( int index = 0; index < numProcesses; index++ )
+    {
+        // skip A(start), which has nothing to run
+        pcbArray[ index ].progCntr++;
+
+        ioRequests[ pcbArray[ index ].procNum ].pcb = &pcbArray[ index ];
+        addReadyPcb( &readyQueue, &pcbArray[ index ] );
+    }
 
-    if( compareString( currPcb.progCntr->opName, "allocate" ) == STR_EQ )
+    while( procsLeft > 0 )
     {
-        // output message
-        accessTimer( LAP_TIMER, timerString );
-        sprintf(tempString, "  %s, Process: %d, MMU attempt to allocate %d/%d/%d\n",
-                             timerString, currPcb.procNum, id, base, offset );
-        logStringPtr = outputLine( logToCode, logStringPtr, tempString );
-
-        // check if mem space is already allocated to or base larger than capac.
-        if( isMemSpaceFree( currPcb.memOpHead, currPcb.procNum, base, id ) == False
-            || base > currPcb.totalMemAvailable )
+        // processes whose I/O has finished become ready again
+        if( procsBlocked > 0 )
         {
-            // output message
-            accessTimer( LAP_TIMER, timerString );
-            sprintf( tempString, "  %s, Process: %d, MMU failed to allocate\n", timerString, currPcb.procNum);
-            logStringPtr = outputLine( logToCode, logStringPtr, tempString );
+            procsBlocked -= serviceInterrupts( &readyQueue, ioRequests, opTable );
+        }
 
-            return segFaultOccurred;
+        if( runningPcb != NULL
+              && isPreemptNeeded( &readyQueue, runningPcb, cyclesRun ) == True )
+        {
+            logSimEvent( configData->cpuSchedCode == CPU_SCHED_RR_P_CODE
+                                    ? PROC_QUANTUM_EVENT : PROC_PREEMPTED_EVENT,
+                      runningPcb->procNum, (int) runningPcb->timeRemaining );
+            setPcbState( runningPcb, READY );
+            addReadyPcb( &readyQueue, runningPcb );
+            runningPcb = NULL;
         }
 
-        // output message
-        currPcb.memOpHead = addMemOpNode( currPcb.memOpHead, id, base, offset, currPcb.procNum );
-        accessTimer( LAP_TIMER, timerString );
-        sprintf( tempString, "  %s, Process: %d, MMU successful allocation\n",
-                                                       timerString, currPcb.procNum );
-        logStringPtr = outputLine( logToCode, logStringPtr, tempString );
-    }
-    else if( compareString( currPcb.progCntr->opName, "access" ) == STR_EQ )
-    {
-        accessTimer( LAP_TIMER, timerString );
-        sprintf( tempString, "  %s, Process: %d, MMU attempt to access %d/%d/%d\n", timerString, currPcb.procNum, id, base, offset );
-        logStringPtr = outputLine( logToCode, logStringPtr, tempString );
+        // RR-P quantum used up with no process waiting; the running
+        // process carries on into a new quantum
+        else if( runningPcb != NULL
+                  && configData->cpuSchedCode == CPU_SCHED_RR_P_CODE
+                  && cyclesRun >= readyQueue.quantumCycles )
+        {
+            cyclesRun = 0;
+        }
 
-        if ( requestMemAccess( currPcb.memOpHead, currPcb.procNum, id, base, offset ) == False )
+        if( runningPcb == NULL )
         {
-            accessTimer(LAP_TIMER, timerString);
-            sprintf( tempString, "  %s, Process: %d, MMU failed to access\n", timerString, currPcb.procNum );
-            logStringPtr = outputLine( logToCode, logStringPtr, tempString );
+            if( isReadyQueueEmpty( &readyQueue ) == True )
+            {
+                logSimEvent( CPU_IDLE_EVENT, 0, 0 );
+                waitForInterrupt();
+                logSimEvent( CPU_IDLE_END_EVENT, 0, 0 );
+                continue;
+            }
 
-            return segFaultOccurred;
+            runningPcb = takeReadyPcb( &readyQueue );
+
+            logSimEvent( PROC_SELECTED_EVENT, runningPcb->procNum,
+                                            (int) runningPcb->timeRemaining );
+            setPcbState( runningPcb, RUNNING );
+            opStarted = False;
+            cyclesRun = 0;
         }
-    }
-    // Seg Fault did not occur
-    return False;
-}
 
-MemMgmtUnit *addMemOpNode( MemMgmtUnit *memOpHead, int memId, int memBase, int memOffset, int procNum )
-{
-    if(memOpHead == NULL)
-    {
-        memOpHead = (MemMgmtUnit *) malloc( sizeof( MemMgmtUnit ) );
-        memOpHead->procNum = procNum;
-        memOpHead->id = memId;
-        memOpHead->base = memBase;
-        memOpHead->offset = memOffset;
-        memOpHead->next = NULL;
-        return memOpHead;
-    }
+        opIndex = runningPcb->progCntr;
 
-    memOpHead->next = addMemOpNode(memOpHead->next, memId, memBase, memOffset, procNum);
-    return memOpHead;
-}
+        // process has reached its A(end), or had a seg fault
+        if( opIndex >= runningPcb->progEnd )
+        {
+            clearMemoryList( &runningPcb->memory->memIndex );
+            clearPageTable( &runningPcb->memory->pageTable, runningPcb->procNum );
 
-Boolean isMemSpaceFree( MemMgmtUnit *memOpPtr, int procNumCheck, int baseCheck, int idCheck )
-{
-    if( memOpPtr == NULL )
-    {
-        return True;
-    }
-    else if( memOpPtr->base == baseCheck
-        || (memOpPtr->procNum == procNumCheck && memOpPtr->id == idCheck) )
-    {
-        return False;
-    }
-    return isMemSpaceFree( memOpPtr->next, procNumCheck, baseCheck, idCheck );
-}
+            logSimEvent( PROC_EXIT_EVENT, runningPcb->procNum, 0 );
+            runningPcb->state = EXIT;
 
-Boolean requestMemAccess( MemMgmtUnit *memOpHead, int procNum, int memId, int memBase, int memOffset )
-{
-    // If requested memory has not been found or we have not added
-    // any nodes to the memory list besides the placeholder node.
-    if( memOpHead == NULL )
-    {
-        return False;
-    }
-    else if( memOpHead->procNum == procNum
-                 && memOpHead->base == memBase
-                     && memOpHead->id == memId )
-    {
-        if(memOffset <= memOpHead->offset)
-        {
-            return True;
+            runningPcb = NULL;
+            procsLeft--;
+            continue;
         }
-        else
+
+        switch( opTable->opKind[ opIndex ] )
         {
-            return False;
+            case MEM_ALLOCATE_OP:
+            case MEM_ACCESS_OP:
+                if( runMemoryMgr( runningPcb, opTable ) == True )
+                {
+                    logSimEvent( SEG_FAULT_EVENT, runningPcb->procNum, 0 );
+                    runningPcb->progCntr = runningPcb->progEnd;
+                }
+                else
+                {
+                    runningPcb->progCntr++;
+                }
+                break;
+
+            case PROCESS_RUN_OP:
+                if( opStarted == False )
+                {
+                    logOpEvent( OP_START_EVENT, runningPcb->procNum, opIndex,
+                                                    opTable->opKind[ opIndex ] );
+                    opStarted = True;
+                }
+
+                // run one cycle, or what is left of the op; time left
+                // in the op table carries over if the process is preempted
+                cycleTime = configData->procCycleRate;
+
+                // FCFS-P never preempts, so the op runs through and
+                // interrupts raised meanwhile are serviced when it ends
+                if( opTable->timeRemaining[ opIndex ] < cycleTime
+                     || configData->cpuSchedCode == CPU_SCHED_FCFS_P_CODE )
+                {
+                    cycleTime = opTable->timeRemaining[ opIndex ];
+                }
+
+                if( cycleTime > 0 )
+                {
+                    runTimer( cycleTime );
+
+                    opTable->timeRemaining[ opIndex ] -= cycleTime;
+                    runningPcb->timeRemaining -= cycleTime;
+                    cyclesRun++;
+                }
+
+                if( opTable->timeRemaining[ opIndex ] <= 0 )
+                {
+                    logOpEvent( OP_END_EVENT, runningPcb->procNum, opIndex,
+                                                    opTable->opKind[ opIndex ] );
+                    runningPcb->progCntr++;
+                    opStarted = False;
+                }
+                break;
+
+            case INPUT_HARD_DRIVE_OP:
+            case INPUT_KEYBOARD_OP:
+            case INPUT_PRINTER_OP:
+            case INPUT_MONITOR_OP:
+            case OUTPUT_HARD_DRIVE_OP:
+            case OUTPUT_KEYBOARD_OP:
+            case OUTPUT_PRINTER_OP:
+            case OUTPUT_MONITOR_OP:
+                // hand the op to its device and give up the CPU
+                logOpEvent( OP_START_EVENT, runningPcb->procNum, opIndex,
+                                                    opTable->opKind[ opIndex ] );
+
+                issueIoOp( &ioRequests[ runningPcb->procNum ], opTable,
+                                                                ioSequence );
+                ioSequence++;
+
+                logOpEvent( PROC_BLOCKED_EVENT, runningPcb->procNum, opIndex,
+                                                    opTable->opKind[ opIndex ] );
+                setPcbState( runningPcb, BLOCKED );
+
+                runningPcb = NULL;
+                procsBlocked++;
+                break;
+
+            default:
+                // start and end ops inside a process have nothing to run
+                runningPcb->progCntr++;
+                break;
         }
     }
 
-    return requestMemAccess( memOpHead->next, procNum, memId, memBase, memOffset );
+    freeReadyQueue( &readyQueue );
+    free( ioRequests );
 }
 
-MemMgmtUnit *clearMemoryList( MemMgmtUnit *memOpHead )
+/*
+    posts the current op of the request's process to its device queue;
+    the device raises the request's interrupt once the op is done
+ */
+void issueIoOp( IoRequest *ioRequest, OpTable *opTable, long sequence )
 {
-    if( memOpHead != NULL )
-    {
-        if( memOpHead->next != NULL )
-        {
-          clearMemoryList( memOpHead->next );
-        }
-        free( memOpHead );
-    }
+    ProcessControlBlock *pcb = ioRequest->pcb;
+    int opIndex = pcb->progCntr;
+
+    ioRequest->runner.opTable = opTable;
+    ioRequest->runner.opIndex = opIndex;
+    ioRequest->runner.procNum = pcb->procNum;
+
+    ioRequest->interrupt.procNum = pcb->procNum;
+    ioRequest->interrupt.opIndex = opIndex;
+    ioRequest->interrupt.sequence = sequence;
+
+    postWork( &deviceQueues[ getIoDevice( opTable->opKind[ opIndex ] ) ],
+                                    &ioRequest->work, runIoOp, ioRequest );
+}
+
+/*
+    runs a posted I/O op on a device service thread; the CPU logs the
+    op, so the device only takes its time and raises the interrupt
+ */
+void *runIoOp( void *request )
+{
+    IoRequest *ioRequest = (IoRequest *) request;
+    OpTable *opTable = ioRequest->runner.opTable;
+
+    runTimer( opTable->timeRemaining[ ioRequest->runner.opIndex ] );
+
+    raiseInterrupt( &ioRequest->interrupt );
+
     return NULL;
 }
 
 /*
-    checks for end of sim, i.e. "S(end)0"
+    services all pending interrupts in order, ending each process's I/O
+    op and making it READY, and returns how many were serviced
  */
-Boolean isEndOfSim( OpCodeType *localPtr )
+int serviceInterrupts( ReadyQueue *readyQueue, IoRequest ioRequests[], OpTable *opTable )
 {
-    if( localPtr->opLtr == 'S' && compareString( localPtr->opName, "end" ) == STR_EQ )
+    Interrupt *interrupt = takeInterrupts();
+    Interrupt *nextInterrupt;
+    ProcessControlBlock *pcb;
+    int opIndex, serviced = 0;
+
+    while( interrupt != NULL )
     {
-        return True;
+        nextInterrupt = interrupt->next;
+        pcb = ioRequests[ interrupt->procNum ].pcb;
+        opIndex = interrupt->opIndex;
+
+        logOpEvent( INTERRUPT_EVENT, pcb->procNum, opIndex,
+                                                opTable->opKind[ opIndex ] );
+        logOpEvent( OP_END_EVENT, pcb->procNum, opIndex,
+                                                opTable->opKind[ opIndex ] );
+
+        pcb->timeRemaining -= opTable->timeRemaining[ opIndex ];
+        pcb->progCntr++;
+
+        setPcbState( pcb, READY );
+        addReadyPcb( readyQueue, pcb );
+
+        serviced++;
+        interrupt = nextInterrupt;
     }
 
-    return False;
+    return serviced;
 }
 
 /*
-    checks for end of process, i.e. "A(end)0"
+    moves a process to a new state and logs the change
  */
-Boolean isEndOfProcess( OpCodeType *localPtr )
+void setPcbState( ProcessControlBlock *pcb, int newState )
 {
-    // if opcode is A(end) return true
-    if( localPtr->opLtr == 'A' && compareString( localPtr->opName, "end" ) == STR_EQ )
+    logStateEvent( pcb->procNum, pcb->state, newState );
+
+    pcb->state = newState;
+}
+
+Boolean runMemoryMgr( ProcessControlBlock *currPcb, OpTable *opTable )
+{
+    // memory data needed, decoded when the op was parsed
+    MemOperand *memOperand = &opTable->memOperand[ currPcb->progCntr ];
+    int opValue = opTable->opValue[ currPcb->progCntr ];
+    int id = memOperand->id;
+    int base = memOperand->base;
+    int offset = memOperand->offset;
+    int faultTime = 0;
+    int block = NO_BLOCK;
+    Boolean segFaultOccurred = True;
+
+    if( opTable->opKind[ currPcb->progCntr ] == MEM_ALLOCATE_OP )
     {
-        return True;
+        // output message
+        logSimEvent( MMU_ALLOCATE_EVENT, currPcb->procNum, opValue );
+
+        // check if mem space is already allocated to or base larger than capac.,
+        // then take the segment's offsets 0 to offset from the physical memory
+        // all processes share; paged memory is given frames as it is accessed
+        if( isMemSpaceFree( &currPcb->memory->memIndex, currPcb->procNum, base, id ) == False
+            || base > getPhysMemoryKB()
+            || ( isPagingOn() == False
+                 && ( block = allocPhysMemory( offset + 1 ) ) == NO_BLOCK ) )
+        {
+            // output message
+            logSimEvent( MMU_ALLOCATE_FAILED_EVENT, currPcb->procNum, 0 );
+
+            return segFaultOccurred;
+        }
+
+        // output message
+        addMemOpNode( &currPcb->memory->memIndex, id, base, offset, currPcb->procNum, block );
+        logSimEvent( MMU_ALLOCATED_EVENT, currPcb->procNum, 0 );
     }
-    // assume not at end of current process
+    else
+    {
+        logSimEvent( MMU_ACCESS_EVENT, currPcb->procNum, opValue );
+
+        // in paged mode the address must also get a page frame
+        if ( requestMemAccess( &currPcb->memory->memIndex, currPcb->procNum, id, base, offset ) == False
+            || ( isPagingOn() == True
+                 && accessPage( &currPcb->memory->pageTable, currPcb->procNum, base + offset, &faultTime ) == False ) )
+        {
+            logSimEvent( MMU_ACCESS_FAILED_EVENT, currPcb->procNum, 0 );
+
+            return segFaultOccurred;
+        }
+
+        // a page fault holds the CPU while the page is read in
+        if( faultTime > 0 )
+        {
+            runTimer( faultTime );
+        }
+    }
+    // Seg Fault did not occur
     return False;
 }
 
-/**
- * Handles output depending on logToCode.
- * If logToCode is MONITOR, prints string.
- * If logToCode is FILE, saves string to buffer.
- * If logToCode is BOTH, prints and saves string to buffer.
- *
- * Note: the string is always added to the buffer to not mess up the
- *       output head pointer, but only outputted to file at end if
- *       logToCode is FILE or BOTH.
+/*
+    outputs the paced timer drift report: how late wake ups were against
+    their absolute deadlines, and the end to end error between simulated
+    and actual elapsed time
  */
-LogString *outputLine(int logToCode, LogString *ouptutPtr, char *inputStr)
+void outputTimerDrift( void )
 {
-    ouptutPtr = addLogStrNode(ouptutPtr, inputStr);
+    char tempString[MAX_STR_LEN];
+    TimerDriftType drift;
+    double meanLateMSec = 0.0;
 
-    if(logToCode != LOGTO_FILE_CODE)
+    getTimerDrift( &drift );
+
+    if( drift.deadlines > 0 )
     {
-        printf("%s", inputStr);
+        meanLateMSec = drift.totalLateMSec / drift.deadlines;
     }
-    return ouptutPtr;
-}
 
+    sprintf( tempString, "\n  Timer drift: %ld deadlines, mean late %.3f ms,"
+                         " max late %.3f ms\n", drift.deadlines,
+                                            meanLateMSec, drift.maxLateMSec );
+    outputLine( tempString );
+
+    sprintf( tempString, "  Simulated %.6f s, elapsed %.6f s, error %.3f ms\n",
+                      drift.simulatedSec, drift.elapsedSec,
+                      ( drift.elapsedSec - drift.simulatedSec ) * 1000 );
+    outputLine( tempString );
+}
 
-/**
- * @details Outputs buffer to the log file.
- *
- * @param[out] ouptutPtr Ouptut linked list
- *
- * @param[in] outputFileName The name of the output log file
- *
- * @return none
+/*
+    outputs the I/O device report: ops each device serviced, the share of
+    its service threads' time spent busy, and the mean and longest number
+    of ops waiting for a service thread
  */
-void outputToFile(LogString *ouptutPtr, char *outputFileName)
+void outputDeviceReport( WorkQueue deviceQueues[], int numDevices )
 {
-    FILE *outputFile = fopen(outputFileName, "w");
+    char tempString[MAX_STR_LEN];
+    char deviceName[MAX_STR_LEN];
+    WorkQueueStats *stats;
+    double elapsedUSec, busyPercent, meanQueue;
 
-    while(ouptutPtr != NULL)
+    outputLine( "\n  I/O device report\n" );
+
+    for( int device = 0; device < numDevices; device++ )
     {
-        fprintf(outputFile, "%s", ouptutPtr->outputStr);
-        ouptutPtr = ouptutPtr->next;
+        stats = &deviceQueues[ device ].stats;
+        elapsedUSec = (double) ( stats->stopUSec - stats->startUSec );
+        busyPercent = 0.0;
+        meanQueue = 0.0;
+
+        if( elapsedUSec > 0.0 )
+        {
+            busyPercent = 100.0 * stats->busyArea
+                                        / ( elapsedUSec * stats->numWorkers );
+            meanQueue = stats->queueArea / elapsedUSec;
+        }
+
+        ioDeviceToString( device, deviceName );
+
+        sprintf( tempString, "  %-10s : %ld ops, %.2f%% busy,"
+                             " mean queue %.2f, max queue %d\n", deviceName,
+                             stats->itemsDone, busyPercent, meanQueue,
+                             stats->maxQueueLength );
+        outputLine( tempString );
     }
-    fclose(outputFile);
 }
 
-
-/**
- * @details Creates log file header when log to code is FILE or BOTH
- *
- * @param[in] configData Pointer to config data struct
- *
- * @param[out] ouptutPtr Ouptut linked list
- *
- * @return LogString Head of linked list
+/*
+    outputs TLB, page table and page fault counts of each process that
+    accessed memory, then of the whole run
  */
-LogString *createLogFileHeader(ConfigDataType *configData, LogString *ouptutPtr)
+void outputPagingReport( ConfigDataType *configData )
 {
-    char tempStr[MAX_STR_LEN];
-
-    ouptutPtr = addLogStrNode(ouptutPtr, "===================================");
-    ouptutPtr = addLogStrNode(ouptutPtr,  "Simulator Log File Header\n\n");
-
-    sprintf(tempStr, "File Name                       : %s\n",
-                                                  configData->metaDataFileName);
+    char tempString[MAX_STR_LEN];
+    char procName[MAX_STR_LEN];
+    char policyName[MAX_STR_LEN];
+    PagingStats *procStats, totals = { 0, 0, 0, 0, 0, 0, 0.0 };
+    PagingStats *stats;
+    int numProcesses;
 
-    ouptutPtr = addLogStrNode(ouptutPtr, tempStr);
+    procStats = getPagingStats( &numProcesses );
 
-    char cpuSchedCode[MAX_STR_LEN];
-    configCodeToString(configData->cpuSchedCode, cpuSchedCode);
-    sprintf(tempStr, "CPU Scheduling                  : %s\n", cpuSchedCode);
-    ouptutPtr = addLogStrNode(ouptutPtr, tempStr);
+    configCodeToString( configData->pagePolicyCode, policyName );
+    sprintf( tempString, "\n  Paging report, %d KB pages, %d entry %d way TLB,"
+                         " %s replacement\n", configData->pageSizeKB,
+                         configData->tlbEntries, configData->tlbWays,
+                         policyName );
+    outputLine( tempString );
 
-    sprintf(tempStr, "Quantum Cycles                  : %d\n",
-                                                     configData->quantumCycles);
-    ouptutPtr = addLogStrNode(ouptutPtr, tempStr);
+    for( int procNum = 0; procNum <= numProcesses; procNum++ )
+    {
+        if( procNum < numProcesses )
+        {
+            stats = &procStats[ procNum ];
 
-    sprintf(tempStr, "Memory Available (KB)           : %d\n",
-                                                      configData->memAvailable);
-    ouptutPtr = addLogStrNode(ouptutPtr, tempStr);
+            if( stats->accesses == 0 )
+            {
+                continue;
+            }
 
-    sprintf(tempStr, "Processor Cycle Rate (ms/cycle) : %d\n",
-                                                     configData->procCycleRate);
-    ouptutPtr = addLogStrNode(ouptutPtr, tempStr);
+            totals.accesses += stats->accesses;
+            totals.tlbHits += stats->tlbHits;
+            totals.pageWalks += stats->pageWalks;
+            totals.pageFaults += stats->pageFaults;
+            totals.evictions += stats->evictions;
+            totals.faultMSec += stats->faultMSec;
+            totals.latencyNSec += stats->latencyNSec;
+            sprintf( procName, "process %d", procNum );
+        }
+        else
+        {
+            stats = &totals;
+            copyString( procName, "all" );
+        }
 
-    sprintf(tempStr, "I/O Cycle Rate (ms/cycle)       : %d\n\n",
-                                                       configData->ioCycleRate);
-    ouptutPtr = addLogStrNode(ouptutPtr, tempStr);
-    return ouptutPtr;
+        sprintf( tempString, "  %-10s : %ld accesses, %.2f%% TLB hits,"
+                             " %ld page walks, mean latency %.2f ns,"
+                             " %ld faults (%.2f%%), %ld evictions,"
+                             " %ld ms fault I/O\n", procName,
+                             stats->accesses,
+                             stats->accesses > 0 ? 100.0 * stats->tlbHits
+                                         / stats->accesses : 0.0,
+                             stats->pageWalks,
+                             stats->accesses > 0 ? stats->latencyNSec
+                                         / stats->accesses : 0.0,
+                             stats->pageFaults,
+                             stats->accesses > 0 ? 100.0 * stats->pageFaults
+                                         / stats->accesses : 0.0,
+                             stats->evictions, stats->faultMSec );
+        outputLine( tempString );
+    }
 }
 
-/**
- * @brief Creates new LogString node.
- *
- * @details Checks if the local head pointer is NULL. If so, creates
- *          new node to be the head pointer. If not, adds new node to end of
- *          linked list.
- *
- * @param[in] head LogString head pointer
- *
- * @param[in] logString Ouptut string for new node
- *
- * @return LogString Head of linked list
+/*
+    outputs how much of physical memory was allocated, how often the core
+    caches served it, and how fragmented it was, on average and at worst
  */
-LogString *addLogStrNode(LogString *head, char *logString)
+void outputMemoryReport( PhysMemory *physMemory )
 {
-    if(head == NULL)
+    char tempString[MAX_STR_LEN];
+    MemCache *cache;
+    long hits = 0, refills = 0, flushes = 0, samples = 0;
+    double internalSum = 0.0, internalPeak = 0.0;
+    double externalSum = 0.0, externalPeak = 0.0;
+
+    for( int index = 0; index < physMemory->numCaches; index++ )
     {
-        head = (LogString *)malloc( sizeof(LogString) );
-        copyString(head->outputStr, logString);
-        head->next = NULL;
-        return head;
-    }
-    // assume end of list not found yet
-    head->next = addLogStrNode(head->next, logString);
+        cache = &physMemory->caches[ index ];
 
-    return head;
-}
+        hits += cache->hits;
+        refills += cache->refills;
+        flushes += cache->flushes;
+        samples += cache->frag.samples;
+        internalSum += cache->frag.internalSum;
+        externalSum += cache->frag.externalSum;
 
-/**
- * @brief Clears LogString linked list.
- *
- * @details Recursively iterates through LogString linked list and
-           returns memory to OS from the bottom of the list upward.
- *
- * @param[in] head LogString head pointer
- *
- * @return LogString Head pointer, which should be NULL
- */
-LogString *clearLogString(LogString *head)
-{
-    if(head != NULL)
-    {
-        if(head->next != NULL)
+        if( cache->frag.internalPeak > internalPeak )
         {
-          clearLogString(head->next);
+            internalPeak = cache->frag.internalPeak;
+        }
+
+        if( cache->frag.externalPeak > externalPeak )
+        {
+            externalPeak = cache->frag.externalPeak;
         }
-        free(head);
     }
-    return NULL;
+
+    if( samples == 0 )
+    {
+        samples = 1;
+    }
+
+    sprintf( tempString, "\n  Memory report, %d KB buddy pool shared by all"
+                         " processes\n", physMemory->pool.totalKB );
+    outputLine( tempString );
+
+    sprintf( tempString, "  allocation : %ld blocks, %ld failed, %ld freed,"
+                         " %ld merges, peak %d KB in use\n",
+                         physMemory->allocations, physMemory->failures,
+                         physMemory->frees, physMemory->pool.stats.merges,
+                         physMemory->peakUsedKB );
+    outputLine( tempString );
+
+    sprintf( tempString, "  caches     : %d cores, %ld hits, %ld refills,"
+                         " %ld flushes\n", physMemory->numCaches, hits,
+                         refills, flushes );
+    outputLine( tempString );
+
+    sprintf( tempString, "  internal   : %.2f%% mean, %.2f%% peak\n",
+                         internalSum / samples, internalPeak );
+    outputLine( tempString );
+
+    sprintf( tempString, "  external   : %.2f%% mean, %.2f%% peak\n",
+                         externalSum / samples, externalPeak );
+    outputLine( tempString );
 }
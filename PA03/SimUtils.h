@@ -6,71 +6,107 @@
 #include "simtimer.h"
 #include "ConfigAccess.h"
 #include "MetaDataAccess.h"
+#include "SimLogger.h"
+#include "SimWorkers.h"
+#include "SimInterrupts.h"
+#include "SimMemory.h"
+#include "SimPaging.h"
 
 // constant for initial memory op creation
 extern const int INIT_MEM;
 
+// constants for splitting the SJF sort across threads
+extern const int PARALLEL_SORT_MIN;
+extern const int MAX_SORT_THREADS;
+
 typedef enum {  NEW,
                 READY,
                 RUNNING,
+                BLOCKED,
                 EXIT } ProcStateStatus;
 
-typedef struct MemMgmtUnit
+// memory fields of a pcb, used only by M ops and at process exit,
+// kept apart from the fields scheduling touches on every op
+typedef struct
 {
-    int procNum;
-    int id;
-    int base;
-    int offset;
-    struct MemMgmtUnit *next;
-} MemMgmtUnit;
+    MemIndex memIndex;
+    PageTable pageTable;
+} PcbMemory;
 
 typedef struct
 {
     int state;
     int procNum;
     double timeRemaining;
-    int totalMemAvailable;
-    OpCodeType *progCntr;
-    MemMgmtUnit *memOpHead;
+    int progCntr;       // op table index of op being run
+    int progEnd;        // op table index of process's A(end)
+    PcbMemory *memory;
 } ProcessControlBlock;
 
-typedef struct LogString
+// heap table of pcbs, with memory fields in a parallel array;
+// pcbs are passed by pointer and stay put once all are added
+typedef struct
 {
-    char outputStr[200];
-    struct LogString *next;
-} LogString;
+    ProcessControlBlock *pcbs;
+    PcbMemory *memory;
+    int numPcbs;
+    int capacity;
+} PcbTable;
 
 typedef struct
 {
-    int logToCode;
-    OpCodeType *opCode;
+    OpTable *opTable;
+    int opIndex;
     int procNum;
-    LogString *logStringPtr;
-    double timeRemaining;
 } ThreadRunner;
 
+// range of the run order sorted by one SJF sort thread
+typedef struct
+{
+    ProcessControlBlock *pcbArray;
+    int *runOrder;
+    int *scratch;
+    int start;
+    int end;
+} SortRange;
+
+// I/O op a blocked process waits on, posted to its device queue;
+// each process has at most one outstanding
+typedef struct
+{
+    ProcessControlBlock *pcb;
+    ThreadRunner runner;
+    WorkItem work;
+    Interrupt interrupt;
+} IoRequest;
+
+// ready queue of the preemptive schedulers, see SimScheduler.h
+struct ReadyQueue;
+
 // functoin prototypes
-void runSimulator( ConfigDataType *configData, OpCodeType *opCodeList);
-void createPCBs( ProcessControlBlock pcbArray[], ConfigDataType *configData, OpCodeType *opCodeList );
-int getNumProcesses( OpCodeType *opCodeList );
-Boolean isProcessStart( OpCodeType *opCodeList );
-double setProcRuntimes( ProcessControlBlock newPcb, int procRate, int ioRate );
-void sortForSJF( ProcessControlBlock pcbArray[], int numProcesses );
-void swap( int index1, int index2, ProcessControlBlock pcbArray[] );
-void *runThread( void *thread );
-void runCurrPcb( ProcessControlBlock currPcb, ConfigDataType *configData, LogString *logStringPtr );
-Boolean runMemoryMgr( int logToCode, LogString *logStrHead, ProcessControlBlock currPcb );
-MemMgmtUnit *addMemOpNode( MemMgmtUnit *memOpHead, int memId, int memBase, int memOffset, int procNum );
-Boolean isMemSpaceFree( MemMgmtUnit *memOp, int procNumCheck, int baseCheck, int idCheck );
-Boolean requestMemAccess( MemMgmtUnit *memOpHead, int procNum, int memId, int memBase, int memOffset );
-MemMgmtUnit *clearMemoryList( MemMgmtUnit *memOpHead );
-Boolean isEndOfSim( OpCodeType *opCodeList );
-Boolean isEndOfProcess( OpCodeType *localPtr );
-LogString *outputLine(int logToCode, LogString *ouptutPtr, char *inputStr);
-void outputToFile(LogString *ouptutPtr, char *outputFileName);
-LogString *createLogFileHeader(ConfigDataType *configData, LogString *ouptutPtr);
-LogString *addLogStrNode(LogString *head, char *logString);
-LogString *clearLogString(LogString *head);
+void runSimulator( ConfigDataType *configData, OpTable *opTable );
+void createPCBs( PcbTable *pcbTable, ConfigDataType *configData, OpTable *opTable );
+void createPcbTable( PcbTable *pcbTable, int capacity );
+ProcessControlBlock *addPcb( PcbTable *pcbTable );
+void freePcbTable( PcbTable *pcbTable );
+double setProcRuntimes( ProcessControlBlock *newPcb, OpTable *opTable, int procRate, int ioRate );
+void sortForSJF( ProcessControlBlock pcbArray[], int runOrder[], int numProcesses );
+void *runSortRange( void *range );
+void mergeRunOrder( ProcessControlBlock pcbArray[], int runOrder[], int scratch[], int start, int mid, int end );
+void startDevices( ConfigDataType *configData );
+void stopDevices( void );
+void *runOp( void *thread );
+void runCurrPcb( ProcessControlBlock *currPcb, OpTable *opTable );
+void runPreemptive( PcbTable *pcbTable, ConfigDataType *configData, OpTable *opTable );
+void issueIoOp( IoRequest *ioRequest, OpTable *opTable, long sequence );
+void *runIoOp( void *request );
+int serviceInterrupts( struct ReadyQueue *readyQueue, IoRequest ioRequests[], OpTable *opTable );
+void setPcbState( ProcessControlBlock *pcb, int newState );
+Boolean runMemoryMgr( ProcessControlBlock *currPcb, OpTable *opTable );
+void outputTimerDrift( void );
+void outputDeviceReport( WorkQueue deviceQueues[], int numDevices );
+void outputPagingReport( ConfigDataType *configData );
+void outputMemoryReport( PhysMemory *physMemory );
 
 #endif // SIM_UTILS_H
 
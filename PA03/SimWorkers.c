@@ -0,0 +1,367 @@
+// Header files
+#include "SimWorkers.h"
+#include "simtimer.h"
+
+// Work queues ////////////////////////////////////////////////////////////////
+
+// Each queue is served by a fixed set of worker threads started once per
+// run. Work items wait in FIFO order; a worker that finds its queue empty
+// suspends itself for timer accounting and sleeps. A submitter that
+// finds an idle worker resumes it on its behalf and posts a wakeup, so
+// in virtual time the clock never advances past queued work. The worker
+// that finishes an item likewise resumes the thread waiting on it, and
+// a worker that frees room in a full queue resumes a blocked submitter.
+// Posted items have no waiting thread; their work function reports
+// completion itself, for example by raising an interrupt.
+
+/**
+ * @brief Starts a work queue and its worker threads.
+ *
+ * @details Each worker is registered with the timer before it starts;
+ *          it suspends itself once it finds no work.
+ *
+ * @param[out] queue Work queue to start
+ *
+ * @param[in] workerCount Number of worker threads to start
+ *
+ * @param[in] maxDepth Most items that may wait for a worker
+ *
+ * @return none
+ */
+void startWorkQueue(WorkQueue *queue, int workerCount, int maxDepth)
+{
+    int index;
+
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->workCond, NULL);
+    pthread_cond_init(&queue->doneCond, NULL);
+    pthread_cond_init(&queue->spaceCond, NULL);
+
+    queue->head = NULL;
+    queue->tail = NULL;
+    queue->threads = (pthread_t *)malloc(workerCount * sizeof(pthread_t));
+    queue->numWorkers = workerCount;
+    queue->idleWorkers = 0;
+    queue->pendingWakeups = 0;
+    queue->busyWorkers = 0;
+    queue->maxDepth = maxDepth;
+    queue->queueLength = 0;
+    queue->spaceWaiters = 0;
+    queue->spaceWakeups = 0;
+    queue->stopRequested = False;
+
+    queue->stats.itemsDone = 0;
+    queue->stats.maxQueueLength = 0;
+    queue->stats.numWorkers = workerCount;
+    queue->stats.startUSec = getTimerUSec();
+    queue->stats.stopUSec = queue->stats.startUSec;
+    queue->stats.lastChangeUSec = queue->stats.startUSec;
+    queue->stats.busyArea = 0.0;
+    queue->stats.queueArea = 0.0;
+
+    for(index = 0; index < workerCount; index++)
+    {
+        registerTimerThread();
+        pthread_create(&queue->threads[index], NULL, runWorker, queue);
+    }
+}
+
+/**
+ * @brief Stops a work queue and its worker threads.
+ *
+ * @details Called once no work is outstanding; idle workers exit
+ *          when woken and are joined before the queue is freed.
+ *          Queue stats are closed at the current time.
+ *
+ * @param[in,out] queue Work queue to stop
+ *
+ * @return none
+ */
+void stopWorkQueue(WorkQueue *queue)
+{
+    int index;
+
+    pthread_mutex_lock(&queue->lock);
+
+    updateQueueStats(queue);
+    queue->stats.stopUSec = queue->stats.lastChangeUSec;
+
+    queue->stopRequested = True;
+    pthread_cond_broadcast(&queue->workCond);
+
+    pthread_mutex_unlock(&queue->lock);
+
+    for(index = 0; index < queue->numWorkers; index++)
+    {
+        pthread_join(queue->threads[index], NULL);
+    }
+
+    free(queue->threads);
+    queue->threads = NULL;
+
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->workCond);
+    pthread_cond_destroy(&queue->doneCond);
+    pthread_cond_destroy(&queue->spaceCond);
+}
+
+/**
+ * @brief Queues an item of work that the caller will wait for.
+ *
+ * @details A full queue suspends the submitter until a worker takes an
+ *          item. If a worker is idle it is counted as running again
+ *          before this returns, so the submitter may block right away.
+ *
+ * @param[in,out] queue Work queue to add to
+ *
+ * @param[out] workItem Work item to queue, owned by the caller
+ *
+ * @param[in] workFunc Function a worker runs for the item
+ *
+ * @param[in] workArg Argument passed to the work function
+ *
+ * @return none
+ */
+void submitWork(WorkQueue *queue, WorkItem *workItem,
+                                void *(*workFunc)(void *), void *workArg)
+{
+    workItem->workFunc = workFunc;
+    workItem->workArg = workArg;
+    workItem->hasWaiter = True;
+
+    queueWorkItem(queue, workItem);
+}
+
+/**
+ * @brief Queues an item of work that no thread will wait for.
+ *
+ * @details The work function reports its own completion; the worker
+ *          neither marks the item done nor resumes anyone for it, so
+ *          the caller may reuse the item as soon as that report comes.
+ *
+ * @param[in,out] queue Work queue to add to
+ *
+ * @param[out] workItem Work item to queue
+ *
+ * @param[in] workFunc Function a worker runs for the item
+ *
+ * @param[in] workArg Argument passed to the work function
+ *
+ * @return none
+ */
+void postWork(WorkQueue *queue, WorkItem *workItem,
+                                void *(*workFunc)(void *), void *workArg)
+{
+    workItem->workFunc = workFunc;
+    workItem->workArg = workArg;
+    workItem->hasWaiter = False;
+
+    queueWorkItem(queue, workItem);
+}
+
+/**
+ * @brief Adds a filled in work item to the tail of a queue.
+ *
+ * @details Blocks while the queue is full, and hands the item to an
+ *          idle worker if there is one.
+ *
+ * @param[in,out] queue Work queue to add to
+ *
+ * @param[in,out] workItem Work item with its function and argument set
+ *
+ * @return none
+ */
+void queueWorkItem(WorkQueue *queue, WorkItem *workItem)
+{
+    workItem->done = False;
+    workItem->next = NULL;
+
+    pthread_mutex_lock(&queue->lock);
+
+    while(queue->queueLength >= queue->maxDepth)
+    {
+        queue->spaceWaiters++;
+
+        pthread_mutex_unlock(&queue->lock);
+        suspendTimerThread();
+        pthread_mutex_lock(&queue->lock);
+
+        while(queue->spaceWakeups == 0)
+        {
+            pthread_cond_wait(&queue->spaceCond, &queue->lock);
+        }
+
+        queue->spaceWakeups--;
+    }
+
+    updateQueueStats(queue);
+
+    if(queue->tail == NULL)
+    {
+        queue->head = workItem;
+    }
+    else
+    {
+        queue->tail->next = workItem;
+    }
+    queue->tail = workItem;
+    queue->queueLength++;
+
+    if(queue->queueLength > queue->stats.maxQueueLength)
+    {
+        queue->stats.maxQueueLength = queue->queueLength;
+    }
+
+    if(queue->idleWorkers > 0)
+    {
+        queue->idleWorkers--;
+        queue->pendingWakeups++;
+        resumeTimerThread();
+        pthread_cond_signal(&queue->workCond);
+    }
+
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * @brief Blocks until a work item is done.
+ *
+ * @details The caller is suspended for timer accounting while it
+ *          waits; the worker finishing the item resumes it.
+ *
+ * @param[in] queue Work queue the item was submitted to
+ *
+ * @param[in] workItem Work item previously passed to submitWork
+ *
+ * @return none
+ */
+void waitForWork(WorkQueue *queue, WorkItem *workItem)
+{
+    suspendTimerThread();
+
+    pthread_mutex_lock(&queue->lock);
+
+    while(workItem->done == False)
+    {
+        pthread_cond_wait(&queue->doneCond, &queue->lock);
+    }
+
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * @brief Worker thread main loop.
+ *
+ * @details Runs queued items in order until stopped. A worker woken
+ *          only by stop was already suspended, so it exits without
+ *          releasing itself again.
+ *
+ * @param[in] queuePtr Work queue this worker serves
+ *
+ * @return NULL
+ */
+void *runWorker(void *queuePtr)
+{
+    WorkQueue *queue = (WorkQueue *)queuePtr;
+    WorkItem *workItem;
+    Boolean hasWaiter;
+
+    pthread_mutex_lock(&queue->lock);
+
+    while(True)
+    {
+        if(queue->head != NULL)
+        {
+            updateQueueStats(queue);
+
+            workItem = queue->head;
+            queue->head = workItem->next;
+
+            if(queue->head == NULL)
+            {
+                queue->tail = NULL;
+            }
+
+            queue->queueLength--;
+            queue->busyWorkers++;
+
+            if(queue->spaceWaiters > 0)
+            {
+                queue->spaceWaiters--;
+                queue->spaceWakeups++;
+                resumeTimerThread();
+                pthread_cond_signal(&queue->spaceCond);
+            }
+
+            pthread_mutex_unlock(&queue->lock);
+
+            hasWaiter = workItem->hasWaiter;
+            workItem->workFunc(workItem->workArg);
+
+            pthread_mutex_lock(&queue->lock);
+
+            updateQueueStats(queue);
+            queue->busyWorkers--;
+            queue->stats.itemsDone++;
+
+            if(hasWaiter == True)
+            {
+                workItem->done = True;
+                resumeTimerThread();
+                pthread_cond_broadcast(&queue->doneCond);
+            }
+        }
+        else if(queue->stopRequested == True)
+        {
+            break;
+        }
+        else
+        {
+            queue->idleWorkers++;
+
+            pthread_mutex_unlock(&queue->lock);
+            suspendTimerThread();
+            pthread_mutex_lock(&queue->lock);
+
+            while(queue->pendingWakeups == 0 && queue->stopRequested == False)
+            {
+                pthread_cond_wait(&queue->workCond, &queue->lock);
+            }
+
+            if(queue->pendingWakeups == 0)
+            {
+                queue->idleWorkers--;
+                pthread_mutex_unlock(&queue->lock);
+
+                return NULL;
+            }
+
+            queue->pendingWakeups--;
+        }
+    }
+
+    pthread_mutex_unlock(&queue->lock);
+    releaseTimerThread();
+
+    return NULL;
+}
+
+/**
+ * @brief Adds time since the last change to the queue stat areas.
+ *
+ * @details Called with the queue lock held, just before the number of
+ *          busy workers or waiting items changes.
+ *
+ * @param[in,out] queue Work queue to update
+ *
+ * @return none
+ */
+void updateQueueStats(WorkQueue *queue)
+{
+    long long nowUSec = getTimerUSec();
+    long long elapsedUSec = nowUSec - queue->stats.lastChangeUSec;
+
+    queue->stats.busyArea += (double)queue->busyWorkers * elapsedUSec;
+    queue->stats.queueArea += (double)queue->queueLength * elapsedUSec;
+    queue->stats.lastChangeUSec = nowUSec;
+}
@@ -0,0 +1,68 @@
+#ifndef SIM_WORKERS_H
+#define SIM_WORKERS_H
+
+#include <pthread.h>
+#include "StringUtils.h"
+
+// one unit of work for a queue, owned by the submitting thread
+// until it is done; a posted item has no waiter and is never
+// touched by the queue once its work function has been called
+typedef struct WorkItem
+{
+    void *(*workFunc)(void *);
+    void *workArg;
+    Boolean hasWaiter;
+    Boolean done;
+    struct WorkItem *next;
+} WorkItem;
+
+// queue activity in simulated time; areas are sums of count * usec,
+// so dividing by elapsed time gives the mean count
+typedef struct
+{
+    long itemsDone;
+    int maxQueueLength;
+    int numWorkers;
+    long long startUSec;
+    long long stopUSec;
+    long long lastChangeUSec;
+    double busyArea;
+    double queueArea;
+} WorkQueueStats;
+
+// FIFO of work items served by its own worker threads, holding at most
+// maxDepth items that no worker has taken yet
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t workCond;
+    pthread_cond_t doneCond;
+    pthread_cond_t spaceCond;
+    WorkItem *head;
+    WorkItem *tail;
+    pthread_t *threads;
+    int numWorkers;
+    int idleWorkers;
+    int pendingWakeups;
+    int busyWorkers;
+    int maxDepth;
+    int queueLength;
+    int spaceWaiters;
+    int spaceWakeups;
+    Boolean stopRequested;
+    WorkQueueStats stats;
+} WorkQueue;
+
+// function prototypes
+void startWorkQueue(WorkQueue *queue, int workerCount, int maxDepth);
+void stopWorkQueue(WorkQueue *queue);
+void submitWork(WorkQueue *queue, WorkItem *workItem,
+                                void *(*workFunc)(void *), void *workArg);
+void postWork(WorkQueue *queue, WorkItem *workItem,
+                                void *(*workFunc)(void *), void *workArg);
+void queueWorkItem(WorkQueue *queue, WorkItem *workItem);
+void waitForWork(WorkQueue *queue, WorkItem *workItem);
+void *runWorker(void *queuePtr);
+void updateQueueStats(WorkQueue *queue);
+
+#endif // SIM_WORKERS_H
@@ -20,7 +20,7 @@ int main( int argc, char **argv )
     char configFileName[MAX_STR_LEN];
     char mdFileName[MAX_STR_LEN];
     ConfigDataType *configDataPtr;
-    OpCodeType *mdDataPtr;
+    OpTable *mdDataPtr;
 
     printf("\nSimulator Program\n");
     printf("==================================\n\n");
@@ -55,7 +55,7 @@ int main( int argc, char **argv )
     {
         displayMetaDataError(mdAccessResult);
         clearConfigData(&configDataPtr);
-        mdDataPtr = clearMetaDataList(mdDataPtr);    // returns null
+        mdDataPtr = clearOpTable(mdDataPtr);    // returns null
         printf("\n");
         return 1;
     }
@@ -71,8 +71,8 @@ int main( int argc, char **argv )
     clearConfigData( &configDataPtr );
 
     // clear meta data
-        // func: clearMetaDataList
-    mdDataPtr = clearMetaDataList( mdDataPtr );
+        // func: clearOpTable
+    mdDataPtr = clearOpTable( mdDataPtr );
 
     // add endline for vertical spacing
         // func: printf
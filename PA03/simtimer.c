@@ -23,13 +23,55 @@
 
 // Header files ///////////////////////////////////////////////////////////////
 
+#include <errno.h>      // for EINTR
 #include "simtimer.h"
 
 // Constants  /////////////////////////////////////////////////////////////////
 
 const char RADIX_POINT = '.';
 
+// Virtual clock state  ///////////////////////////////////////////////////////
+
+// In virtual mode no thread ever sleeps; a thread calling runTimer
+// posts its wake time to the event queue and blocks. Whenever every
+// simulation thread is blocked the clock jumps to the earliest event
+// and releases that thread, so the run takes no longer than its
+// bookkeeping while the log reads exactly as a real time run would.
+
+static int timerMode = REAL_TIMER_MODE;
+static pthread_mutex_t timerLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t timerCond = PTHREAD_COND_INITIALIZER;
+static long long virtualUSec = 0;
+static int activeThreads = 1;    // main thread is always counted
+static long eventSequence = 0;
+static TimerEvent *eventHeap = NULL;
+static int eventCount = 0, eventCapacity = 0;
+
+// Paced mode runs the same event queue, but before each release the
+// clock sleeps until that event's absolute deadline measured from the
+// monotonic anchor taken at ZERO_TIMER. Time spent logging between
+// ops is absorbed by the next deadline instead of accumulating.
+
+static long long anchorUSec = 0;
+static TimerDriftType timerDrift;
+
+// real mode start time, kept for getTimerUSec
+static long long realStartUSec = 0;
+
 void runTimer( int milliSeconds )
+   {
+    if( timerMode == VIRTUAL_TIMER_MODE || timerMode == PACED_TIMER_MODE )
+       {
+        runVirtualTimer( milliSeconds );
+       }
+
+    else
+       {
+        runBusyTimer( milliSeconds );
+       }
+   }
+
+void runBusyTimer( int milliSeconds )
    {
     struct timeval startTime, endTime;
     int startSec, startUSec, endSec, endUSec;
@@ -63,6 +105,300 @@ void runTimer( int milliSeconds )
        }
    }
 
+/*
+   Blocks the calling thread for the given simulated time; the clock
+   only moves once no other simulation thread is still running
+*/
+void runVirtualTimer( int milliSeconds )
+   {
+    Boolean released = False;
+
+    pthread_mutex_lock( &timerLock );
+
+    pushTimerEvent( virtualUSec + (long long) milliSeconds * 1000,
+                                                                  &released );
+    activeThreads--;
+
+    advanceVirtualClock();
+
+    while( released == False )
+       {
+        pthread_cond_wait( &timerCond, &timerLock );
+       }
+
+    pthread_mutex_unlock( &timerLock );
+   }
+
+/*
+   Blocks the calling thread until every other thread with work due at
+   the current simulated time has run and blocked again, so that it
+   sees all of their results; returns at once in real mode
+*/
+void syncTimerThreads( void )
+   {
+    if( timerMode != REAL_TIMER_MODE )
+       {
+        runVirtualTimer( 0 );
+       }
+   }
+
+void setTimerMode( int modeCode )
+   {
+    timerMode = modeCode;
+   }
+
+int getTimerMode( void )
+   {
+    return timerMode;
+   }
+
+/*
+   Thread accounting for virtual and paced modes. A creator registers a thread
+   before starting it, and the thread releases itself as its last act.
+   A thread about to block on anything other than runTimer suspends
+   itself, and whichever thread ends that wait resumes it, so the
+   clock never advances past work that is about to happen.
+*/
+void registerTimerThread( void )
+   {
+    if( timerMode != REAL_TIMER_MODE )
+       {
+        pthread_mutex_lock( &timerLock );
+
+        activeThreads++;
+
+        pthread_mutex_unlock( &timerLock );
+       }
+   }
+
+void releaseTimerThread( void )
+   {
+    suspendTimerThread();
+   }
+
+void suspendTimerThread( void )
+   {
+    if( timerMode != REAL_TIMER_MODE )
+       {
+        pthread_mutex_lock( &timerLock );
+
+        activeThreads--;
+
+        advanceVirtualClock();
+
+        pthread_mutex_unlock( &timerLock );
+       }
+   }
+
+void resumeTimerThread( void )
+   {
+    registerTimerThread();
+   }
+
+/*
+   Releases the earliest waiting thread once all threads are blocked;
+   timer lock must be held by the caller
+*/
+void advanceVirtualClock( void )
+   {
+    TimerEvent nextEvent;
+
+    if( activeThreads == 0 && eventCount > 0 )
+       {
+        nextEvent = popTimerEvent();
+
+        // no thread is running, so the lock can be dropped while pacing;
+        // an event due now, posted by syncTimerThreads, needs no sleep
+        if( timerMode == PACED_TIMER_MODE
+                                    && nextEvent.wakeUSec > virtualUSec )
+           {
+            pthread_mutex_unlock( &timerLock );
+
+            sleepUntilDeadline( nextEvent.wakeUSec );
+
+            pthread_mutex_lock( &timerLock );
+           }
+
+        virtualUSec = nextEvent.wakeUSec;
+        *( nextEvent.releasedPtr ) = True;
+
+        activeThreads++;
+
+        pthread_cond_broadcast( &timerCond );
+       }
+   }
+
+void pushTimerEvent( long long wakeUSec, Boolean *releasedPtr )
+   {
+    int index, parent;
+    TimerEvent newEvent;
+
+    if( eventCount == eventCapacity )
+       {
+        eventCapacity = eventCapacity == 0 ? 16 : eventCapacity * 2;
+
+        eventHeap = (TimerEvent *) realloc( eventHeap,
+                                      eventCapacity * sizeof( TimerEvent ) );
+       }
+
+    newEvent.wakeUSec = wakeUSec;
+    newEvent.sequence = eventSequence;
+    newEvent.releasedPtr = releasedPtr;
+
+    eventSequence++;
+
+    // sift new event up from the bottom of the heap
+    index = eventCount;
+
+    eventCount++;
+
+    while( index > 0 )
+       {
+        parent = ( index - 1 ) / 2;
+
+        if( isEarlierEvent( newEvent, eventHeap[ parent ] ) == False )
+           {
+            break;
+           }
+
+        eventHeap[ index ] = eventHeap[ parent ];
+
+        index = parent;
+       }
+
+    eventHeap[ index ] = newEvent;
+   }
+
+TimerEvent popTimerEvent( void )
+   {
+    TimerEvent topEvent = eventHeap[ 0 ];
+    TimerEvent lastEvent;
+    int index = 0, child;
+
+    eventCount--;
+
+    lastEvent = eventHeap[ eventCount ];
+
+    // sift last event down from the top of the heap
+    child = 1;
+
+    while( child < eventCount )
+       {
+        if( child + 1 < eventCount
+             && isEarlierEvent( eventHeap[ child + 1 ],
+                                          eventHeap[ child ] ) == True )
+           {
+            child++;
+           }
+
+        if( isEarlierEvent( eventHeap[ child ], lastEvent ) == False )
+           {
+            break;
+           }
+
+        eventHeap[ index ] = eventHeap[ child ];
+
+        index = child;
+        child = 2 * index + 1;
+       }
+
+    eventHeap[ index ] = lastEvent;
+
+    return topEvent;
+   }
+
+Boolean isEarlierEvent( TimerEvent oneEvent, TimerEvent otherEvent )
+   {
+    if( oneEvent.wakeUSec != otherEvent.wakeUSec )
+       {
+        return oneEvent.wakeUSec < otherEvent.wakeUSec ? True : False;
+       }
+
+    return oneEvent.sequence < otherEvent.sequence ? True : False;
+   }
+
+/*
+   Frees the event queue and empties it, for a clock no thread waits on
+*/
+void freeTimerEvents( void )
+   {
+    pthread_mutex_lock( &timerLock );
+
+    free( eventHeap );
+
+    eventHeap = NULL;
+    eventCount = 0;
+    eventCapacity = 0;
+
+    pthread_mutex_unlock( &timerLock );
+   }
+
+/*
+   Sleeps until the given simulated time past the anchor using an
+   absolute monotonic deadline, then records how late the wake up was
+*/
+void sleepUntilDeadline( long long wakeUSec )
+   {
+    struct timespec deadline;
+    long long deadlineUSec = anchorUSec + wakeUSec;
+    double lateMSec;
+    int sleepResult;
+
+    deadline.tv_sec = (time_t) ( deadlineUSec / 1000000 );
+    deadline.tv_nsec = (long) ( deadlineUSec % 1000000 ) * 1000;
+
+    // interrupted by a signal, sleep again to the same deadline
+    do
+       {
+        sleepResult = clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME,
+                                                           &deadline, NULL );
+       }
+    while( sleepResult == EINTR );
+
+    // any other failure will not go away, so report it and go on
+    // without pacing this wake up
+    if( sleepResult != 0 )
+       {
+        fprintf( stderr, "ERROR: Paced timer sleep failed: %s\n",
+                                                    strerror( sleepResult ) );
+       }
+
+    lateMSec = (double) ( getMonotonicUSec() - deadlineUSec ) / 1000;
+
+    timerDrift.deadlines++;
+    timerDrift.totalLateMSec += lateMSec;
+
+    if( lateMSec > timerDrift.maxLateMSec )
+       {
+        timerDrift.maxLateMSec = lateMSec;
+       }
+   }
+
+long long getMonotonicUSec( void )
+   {
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return (long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+   }
+
+/*
+   Reports paced deadline lateness along with simulated and actual
+   elapsed time since the anchor, for the System Stop drift report
+*/
+void getTimerDrift( TimerDriftType *drift )
+   {
+    pthread_mutex_lock( &timerLock );
+
+    *drift = timerDrift;
+
+    drift->simulatedSec = (double) virtualUSec / 1000000;
+    drift->elapsedSec = (double) ( getMonotonicUSec() - anchorUSec ) / 1000000;
+
+    pthread_mutex_unlock( &timerLock );
+   }
+
 double accessTimer( int controlCode, char *timeStr )
    {
     static Boolean running = False;
@@ -71,6 +407,22 @@ double accessTimer( int controlCode, char *timeStr )
     struct timeval startData, lapData, endData;
     double fpTime = 0.0;
 
+    // no thread waits on the clock once it is stopped
+    if( controlCode == STOP_TIMER )
+       {
+        freeTimerEvents();
+       }
+
+    if( timerMode == VIRTUAL_TIMER_MODE )
+       {
+        return accessVirtualTimer( controlCode, timeStr );
+       }
+
+    if( timerMode == PACED_TIMER_MODE )
+       {
+        return accessPacedTimer( controlCode, timeStr );
+       }
+
     switch( controlCode )
        {
         case ZERO_TIMER:
@@ -80,6 +432,8 @@ double accessTimer( int controlCode, char *timeStr )
            startSec = startData.tv_sec;
            startUSec = startData.tv_usec;
 
+           realStartUSec = (long long) startSec * 1000000 + startUSec;
+
            fpTime = 0.000000000;
            lapSec = 0.000000000;
            lapUSec = 0.000000000;
@@ -129,6 +483,94 @@ double accessTimer( int controlCode, char *timeStr )
     return fpTime;
    }
 
+/*
+   Returns time since ZERO_TIMER in microseconds for the current mode,
+   without building a time string
+*/
+long long getTimerUSec( void )
+   {
+    struct timeval lapData;
+    long long lapUSec;
+
+    if( timerMode == VIRTUAL_TIMER_MODE )
+       {
+        pthread_mutex_lock( &timerLock );
+
+        lapUSec = virtualUSec;
+
+        pthread_mutex_unlock( &timerLock );
+       }
+
+    else if( timerMode == PACED_TIMER_MODE )
+       {
+        lapUSec = getMonotonicUSec() - anchorUSec;
+       }
+
+    else
+       {
+        gettimeofday( &lapData, NULL );
+
+        lapUSec = (long long) lapData.tv_sec * 1000000 + lapData.tv_usec
+                                                              - realStartUSec;
+       }
+
+    return lapUSec;
+   }
+
+/*
+   Reports the virtual clock, which starts at zero with the simulation
+*/
+double accessVirtualTimer( int controlCode, char *timeStr )
+   {
+    long long lapUSec;
+
+    pthread_mutex_lock( &timerLock );
+
+    if( controlCode == ZERO_TIMER )
+       {
+        virtualUSec = 0;
+       }
+
+    lapUSec = virtualUSec;
+
+    pthread_mutex_unlock( &timerLock );
+
+    timeToString( (int) ( lapUSec / 1000000 ), (int) ( lapUSec % 1000000 ),
+                                                                     timeStr );
+
+    return (double) lapUSec / 1000000;
+   }
+
+/*
+   Reports actual monotonic time since the anchor, which ZERO_TIMER sets
+   along with restarting the virtual clock the deadlines are taken from
+*/
+double accessPacedTimer( int controlCode, char *timeStr )
+   {
+    long long lapUSec;
+
+    pthread_mutex_lock( &timerLock );
+
+    if( controlCode == ZERO_TIMER )
+       {
+        anchorUSec = getMonotonicUSec();
+        virtualUSec = 0;
+
+        timerDrift.deadlines = 0;
+        timerDrift.maxLateMSec = 0.0;
+        timerDrift.totalLateMSec = 0.0;
+       }
+
+    lapUSec = getMonotonicUSec() - anchorUSec;
+
+    pthread_mutex_unlock( &timerLock );
+
+    timeToString( (int) ( lapUSec / 1000000 ), (int) ( lapUSec % 1000000 ),
+                                                                     timeStr );
+
+    return (double) lapUSec / 1000000;
+   }
+
 double processTime( double startSec, double endSec,
                            double startUSec, double endUSec, char *timeStr )
    {
@@ -22,7 +22,9 @@
 // Header files ///////////////////////////////////////////////////////////////
 
 #include <sys/time.h>
+#include <time.h>
 #include <string.h>
+#include <pthread.h>
 #include <math.h>
 #include "StringUtils.h"
 #include "SimUtils.h"
@@ -31,13 +33,55 @@
 
 enum TIMER_CTRL_CODES { ZERO_TIMER, LAP_TIMER, STOP_TIMER };
 
+enum TIMER_MODE_CODES { REAL_TIMER_MODE, VIRTUAL_TIMER_MODE,
+                                                          PACED_TIMER_MODE };
+
+// pending wake up of a thread waiting in virtual time,
+// ordered by wake time then by sequence for reproducible runs
+typedef struct
+   {
+    long long wakeUSec;
+    long sequence;
+    Boolean *releasedPtr;
+   } TimerEvent;
+
+// lateness of paced wake ups against their absolute deadlines
+typedef struct
+   {
+    long deadlines;
+    double maxLateMSec;
+    double totalLateMSec;
+    double simulatedSec;
+    double elapsedSec;
+   } TimerDriftType;
+
 extern const char RADIX_POINT;
 extern const char SPACE;
 
 // Function Prototyp  /////////////////////////////////////////////////////////
 
 void runTimer( int milliSeconds );
+void runBusyTimer( int milliSeconds );
+void runVirtualTimer( int milliSeconds );
+void syncTimerThreads( void );
+void setTimerMode( int modeCode );
+int getTimerMode( void );
+void registerTimerThread( void );
+void releaseTimerThread( void );
+void suspendTimerThread( void );
+void resumeTimerThread( void );
+void advanceVirtualClock( void );
+void pushTimerEvent( long long wakeUSec, Boolean *releasedPtr );
+TimerEvent popTimerEvent( void );
+Boolean isEarlierEvent( TimerEvent oneEvent, TimerEvent otherEvent );
+void freeTimerEvents( void );
+void sleepUntilDeadline( long long wakeUSec );
+long long getMonotonicUSec( void );
+void getTimerDrift( TimerDriftType *drift );
 double accessTimer( int controlCode, char *timeStr );
+long long getTimerUSec( void );
+double accessVirtualTimer( int controlCode, char *timeStr );
+double accessPacedTimer( int controlCode, char *timeStr );
 double processTime( double startSec, double endSec,
                            double startUSec, double endUSec, char *timeStr );
 void timeToString( int secTime, int uSecTime, char *timeStr );
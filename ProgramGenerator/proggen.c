@@ -1,4 +1,6 @@
 // header files
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -6,17 +8,21 @@
 #include "proggen.h"
 
 // main program
-int main()
+int main( int argc, char *argv[] )
    {
     // initialize program
 
        // initialize variables
        int procPercentage, numOps, numPrograms;
-       int progCtr, opCtr, lineLength = 0;
        char fileName[ STD_STR_LEN ];
-       FILE *outFilePtr;
-       char opString[ STD_STR_LEN ];
-       char tempString[ STD_STR_LEN ];
+
+       // check for command line parameters
+       if( argc > 1 )
+          {
+           // generate files without prompting, return result
+              // function: runBatch
+           return runBatch( argc, argv );
+          }
 
        // initialize random generator
           // function: srand
@@ -46,10 +52,184 @@ int main()
     printf( "Enter number of programs: " );
     scanf( "%d", &numPrograms );
 
+    // create meta-data file
+       // function: writeMetaDataFile
+    if( writeMetaDataFile( fileName, procPercentage,
+                                        numOps, numPrograms ) == False )
+       {
+        // report file failure
+           // function: printf
+        printf( "Unable to open file: %s\n", fileName );
+
+        // return failure
+        return 1;
+       }
+
+    // shut down program
+
+       // return success
+       return 0; 
+   }
+
+// supporting function implementations
+
+int runBatch( int argc, char *argv[] )
+   {
+    // initialize variables
+    long procPercentage, numOps, numPrograms, seed, numFiles = 1;
+    int fileIndex;
+    char fileName[ MAX_NAME_LEN ];
+
+    // check for number of parameters, and for valid values
+       // function: getArgValue
+    if( ( argc != SINGLE_RUN_ARGS && argc != BATCH_RUN_ARGS )
+        || getArgValue( argv[ 2 ], MIN_PERCENT, MAX_PERCENT,
+                                              &procPercentage ) == False
+        || getArgValue( argv[ 3 ], 1, INT_MAX, &numOps ) == False
+        || getArgValue( argv[ 4 ], 1, INT_MAX, &numPrograms ) == False
+        || getArgValue( argv[ 5 ], 0, INT_MAX, &seed ) == False
+        || ( argc == BATCH_RUN_ARGS
+             && getArgValue( argv[ 6 ], 1, INT_MAX, &numFiles ) == False ) )
+       {
+        // show usage
+           // function: fprintf
+        fprintf( stderr, "Usage: %s <file name> <percent processing> "
+                         "<ops per program> <programs> <seed> [<files>]\n",
+                                                                 argv[ 0 ] );
+
+        // return failure
+        return 1;
+       }
+
+    // loop across number of files
+    for( fileIndex = 0; fileIndex < numFiles; fileIndex++ )
+       {
+        // check for single file, use name as given
+           // function: strlen, strcpy
+        if( numFiles == 1 && strlen( argv[ 1 ] ) < (size_t) MAX_NAME_LEN )
+           {
+            strcpy( fileName, argv[ 1 ] );
+           }
+
+        // otherwise, check for numbered name not fitting
+           // function: makeBatchFileName
+        else if( numFiles == 1 || makeBatchFileName( argv[ 1 ], fileIndex,
+                                               numFiles, fileName ) == False )
+           {
+            // report name failure
+               // function: fprintf
+            fprintf( stderr, "File name too long: %s\n", argv[ 1 ] );
+
+            // return failure
+            return 1;
+           }
+
+        // seed each file on its own, so file n of a batch matches
+        // a single file made with the seed plus n
+           // function: srand
+        srand( (unsigned int) seed + (unsigned int) fileIndex );
+
+        // create meta-data file
+           // function: writeMetaDataFile
+        if( writeMetaDataFile( fileName, (int) procPercentage,
+                              (int) numOps, (int) numPrograms ) == False )
+           {
+            // report file failure
+               // function: fprintf
+            fprintf( stderr, "Unable to open file: %s\n", fileName );
+
+            // return failure
+            return 1;
+           }
+       }
+    // end loop across number of files
+
+    // report files written
+       // function: printf
+    printf( "Wrote %ld meta-data file(s) from seed %ld\n", numFiles, seed );
+
+    // return success
+    return 0;
+   }
+
+Boolean getArgValue( char argStr[], long low, long high, long *value )
+   {
+    // initialize end of number
+    char *endPtr;
+
+    // convert string to number
+       // function: strtol
+    errno = 0;
+    *value = strtol( argStr, &endPtr, 10 );
+
+    // check for no digits, trailing characters, overflow or range
+    if( endPtr == argStr || *endPtr != NULL_CHAR || errno != 0
+                                        || *value < low || *value > high )
+       {
+        // return invalid
+        return False;
+       }
+
+    // return valid
+    return True;
+   }
+
+Boolean makeBatchFileName( char baseName[], int fileIndex,
+                                             int numFiles, char fileName[] )
+   {
+    // initialize variables
+    int digits = 1, lastIndex = numFiles - 1, stemLength, nameLength;
+    char *extPtr = strrchr( baseName, '.' );
+    char *dirPtr = strrchr( baseName, '/' );
+
+    // find digits needed for last index, so the names sort in order
+    while( lastIndex >= 10 )
+       {
+        lastIndex /= 10;
+        digits++;
+       }
+
+    // check for no extension, or a dot only in the directory part
+    if( extPtr == NULL || ( dirPtr != NULL && extPtr < dirPtr ) )
+       {
+        // number goes at end of name
+           // function: strlen
+        extPtr = baseName + strlen( baseName );
+       }
+
+    // set name as stem, underscore, padded number, extension
+       // function: snprintf
+    stemLength = (int) ( extPtr - baseName );
+    nameLength = snprintf( fileName, MAX_NAME_LEN, "%.*s_%0*d%s",
+                              stemLength, baseName, digits, fileIndex, extPtr );
+
+    // return whether name fit
+    return nameLength < MAX_NAME_LEN;
+   }
+
+Boolean writeMetaDataFile( char fileName[], int procPercentage,
+                                             int numOps, int numPrograms )
+   {
+    // initialize variables
+    int progCtr, opCtr, lineLength = 0;
+    FILE *outFilePtr;
+    char opString[ STD_STR_LEN ];
+    char tempString[ STD_STR_LEN ];
+
+    // initialize a control value so the first I/O of each file is input
+    Boolean firstOp = True;
+
     // open file
        // function: fopen
     outFilePtr = fopen( fileName, "w" );
 
+    // check for file not opened
+    if( outFilePtr == NULL )
+       {
+        // return failure
+        return False;
+       }
+
     // output file description header
        // function: fputs
     fputs( "Start Program Meta-Data Code:\n", outFilePtr );
@@ -86,7 +266,7 @@ int main()
            {
             // get new op
             // function: getNewOp
-            getNewOp( procPercentage, opString );
+            getNewOp( procPercentage, &firstOp, opString );
 
             // update length, output end of line as needed
                // function: checkLineLength
@@ -136,14 +316,10 @@ int main()
        // function: fclose
     fclose( outFilePtr );
 
-    // shut down program
-
-       // return success
-       return 0; 
+    // return success
+    return True;
    }
 
-// supporting function implementations
-
 int getRandBetween( int low, int high )
    {
     // initialize range
@@ -171,14 +347,11 @@ Boolean getOdds( int oddPercent )
     return False;
    }
 
-void getNewOp( int percent, char opStr[] )
+void getNewOp( int percent, Boolean *firstOp, char opStr[] )
    {
     // initialize recursive start index
     int recStartIndex = 0;
 
-    // initialize a control value so the first operation is always input
-    static Boolean firstOp = True;
-    
     // initialize speedFactor to 1, for processor
         // speedFactor makes I/O devices relatively slower than the processor
         // - although not as relatively slow as they would really be
@@ -202,7 +375,7 @@ void getNewOp( int percent, char opStr[] )
        {
         // check for first I/O operations, or chance of input operation
              // function: getOdds
-        if( firstOp || getOdds( INPUT_CHANCE ) == True ) // input process
+        if( *firstOp || getOdds( INPUT_CHANCE ) == True ) // input process
            {
             // check for odds of hard drive
                 // function: getOdds
@@ -228,7 +401,7 @@ void getNewOp( int percent, char opStr[] )
                }
 
             // toggle first operation flag
-            firstOp = False;
+            *firstOp = False;
            }
 
         // otherwise, assume output operation
@@ -7,6 +7,7 @@
 // global constants
 
 const int STD_STR_LEN = 45;
+const int MAX_NAME_LEN = 256;
 const int MAX_LINE_LENGTH = 55;
 const int INPUT_CHANCE = 50;
 const int OUTPUT_CHANCE = 33;
@@ -14,12 +15,22 @@ const int OPTIME_MAX = 15;
 const int OPTIME_MIN = 5;
 const char NULL_CHAR = '\0';
 const char ENDLINE_CHAR[] = "\n";
+const int MIN_PERCENT = 0;
+const int MAX_PERCENT = 100;
+const int SINGLE_RUN_ARGS = 6;
+const int BATCH_RUN_ARGS = 7;
 
 typedef enum { False, True } Boolean;
 
 // function prototypes
 
-void getNewOp( int percent, char opStr[] );
+int runBatch( int argc, char *argv[] );
+Boolean getArgValue( char argStr[], long low, long high, long *value );
+Boolean makeBatchFileName( char baseName[], int fileIndex,
+                                             int numFiles, char fileName[] );
+Boolean writeMetaDataFile( char fileName[], int procPercentage,
+                                             int numOps, int numPrograms );
+void getNewOp( int percent, Boolean *firstOp, char opStr[] );
 Boolean getOdds( int oddPercent );
 int getRandBetween( int low, int high );
 int checkLineLength( char str[], int startLen, FILE *fileOutPtr );